@@ -0,0 +1,124 @@
+/**
+ * @file: AutoConnect/include/AutoConnect/AddressSet.h
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#ifndef AUTOCONNECT_ADDRESSSET_H
+#define AUTOCONNECT_ADDRESSSET_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <arpa/inet.h>
+
+namespace AutoConnect {
+
+    /**
+     * Set of IPv4 addresses kept as packed 32-bit values in one flat array with linear probing.
+     * Lookups touch one or two cache lines and inserting does not allocate until the table grows.
+     * 0.0.0.0 marks an empty slot and can never be a member.
+     */
+    class AddressSet {
+    public:
+        /**
+         * @param address IPv4 address in network byte order
+         * @return true if the address was not in the set before
+         */
+        bool insert(uint32_t address) {
+            if (address == 0)
+                return false;
+            // Keep the table at most half full so probe sequences stay short
+            if ((m_Size + 1) * 2 > m_Slots.size())
+                grow();
+            size_t slot = find(address);
+            if (m_Slots[slot] == address)
+                return false;
+            m_Slots[slot] = address;
+            ++m_Size;
+            return true;
+        }
+
+        [[nodiscard]] bool contains(uint32_t address) const {
+            return address != 0 && !m_Slots.empty() && m_Slots[find(address)] == address;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return m_Size;
+        }
+
+        [[nodiscard]] bool empty() const {
+            return m_Size == 0;
+        }
+
+        void clear() {
+            m_Slots.assign(m_Slots.size(), 0);
+            m_Size = 0;
+        }
+
+        /** Dotted decimal form of an address in network byte order */
+        static std::string toString(uint32_t address) {
+            char text[INET_ADDRSTRLEN] = {};
+            inet_ntop(AF_INET, &address, text, sizeof(text));
+            return text;
+        }
+
+    private:
+        /** Slot that holds address or the empty slot where it would go */
+        [[nodiscard]] size_t find(uint32_t address) const {
+            size_t mask = m_Slots.size() - 1;
+            // Fibonacci hashing spreads addresses of one subnet, which differ only in the last byte, over the table
+            size_t slot = (static_cast<uint64_t>(address) * 0x9E3779B97F4A7C15ull >> 32) & mask;
+            while (m_Slots[slot] != 0 && m_Slots[slot] != address)
+                slot = (slot + 1) & mask;
+            return slot;
+        }
+
+        void grow() {
+            std::vector<uint32_t> old(m_Slots.empty() ? 16 : m_Slots.size() * 2, 0);
+            old.swap(m_Slots);
+            m_Size = 0;
+            for (auto address: old) {
+                if (address != 0) {
+                    m_Slots[find(address)] = address;
+                    ++m_Size;
+                }
+            }
+        }
+
+        std::vector<uint32_t> m_Slots; ///< Power of two sized
+        size_t m_Size = 0;
+    };
+}
+
+#endif //AUTOCONNECT_ADDRESSSET_H
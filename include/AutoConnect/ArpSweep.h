@@ -0,0 +1,140 @@
+/**
+ * @file: AutoConnect/include/AutoConnect/ArpSweep.h
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#ifndef AUTOCONNECT_ARPSWEEP_H
+#define AUTOCONNECT_ARPSWEEP_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "AutoConnect/AddressSet.h"
+
+// MultiSense cameras ship with this address, its /24 is swept first
+#define ARP_SWEEP_DEFAULT_CAMERA_ADDRESS "10.66.171.21"
+// Requests are sent in bursts at most this often, so a sweep does not wake the event loop for every request
+#define ARP_SWEEP_INTERVAL_MS 10
+// Subnets larger than this are only swept in the /24 around the adapter's own address
+#define ARP_SWEEP_MAX_PREFIX 22
+
+namespace AutoConnect {
+
+    /**
+     * Rate limited ARP sweep over the subnets a camera is likely to be in.
+     * Requests are broadcast from a separate packet socket that receives nothing. Replies arrive on the adapter's
+     * capture socket and are recognized with isReply(). The target order is the camera default subnet starting at
+     * the default address, then the adapter's own subnets, then any extra subnets given by the user.
+     */
+    class ArpSweep {
+    public:
+        struct Subnet {
+            uint32_t address = 0; ///< Host byte order
+            uint32_t prefix = 24;
+        };
+
+        ArpSweep() = default;
+
+        ~ArpSweep();
+
+        ArpSweep(const ArpSweep &) = delete;
+
+        ArpSweep &operator=(const ArpSweep &) = delete;
+
+        /**
+         * Collects the adapter's hardware and IPv4 addresses and builds the target list
+         * @param rate requests per second
+         * @return false if the sweep cannot run on this adapter. errorMessage() tells why
+         */
+        bool open(uint32_t ifIndex, const std::string &ifName, const std::vector<Subnet> &extraSubnets, uint32_t rate);
+
+        void close();
+
+        /**
+         * Sends the requests that are due at the configured rate
+         * @return milliseconds until more requests are due, or -1 once all targets were sent or on failure
+         */
+        int send();
+
+        /**
+         * Checks whether a captured frame is a reply to one of our requests
+         * @param address set to the replying address in network byte order
+         */
+        bool isReply(const uint8_t *data, uint32_t length, uint32_t &address) const;
+
+        [[nodiscard]] bool done() const {
+            return m_Next >= m_Targets.size();
+        }
+
+        [[nodiscard]] size_t sent() const {
+            return m_Next;
+        }
+
+        [[nodiscard]] size_t targets() const {
+            return m_Targets.size();
+        }
+
+        /** Our sender address in network byte order, 0.0.0.0 if the adapter has none */
+        [[nodiscard]] uint32_t senderAddress() const {
+            return m_SenderAddress;
+        }
+
+        [[nodiscard]] const std::string &errorMessage() const {
+            return m_Error;
+        }
+
+        /** Parses a subnet in a.b.c.d/n notation */
+        static bool parseSubnet(const std::string &text, Subnet &subnet);
+
+    private:
+        void addSubnet(const Subnet &subnet, uint32_t first = 0);
+
+        void setError(const char *what);
+
+        int m_Fd = -1;
+        uint32_t m_IfIndex = 0;
+        uint8_t m_HardwareAddress[6] = {};
+        uint32_t m_SenderAddress = 0;
+        std::vector<uint32_t> m_Targets; ///< Network byte order
+        AddressSet m_Known;
+        size_t m_Next = 0;
+        uint32_t m_Rate = 0;
+        std::chrono::steady_clock::time_point m_Started;
+        std::string m_Error;
+    };
+}
+
+#endif //AUTOCONNECT_ARPSWEEP_H
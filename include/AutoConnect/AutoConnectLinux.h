@@ -38,17 +38,74 @@
 #define AUTOCONNECT_AUTOCONNECTLINUX_H
 
 
+#include <algorithm>
+#include <atomic>
+#include <map>
 #include <thread>
 #include <mutex>
 #include <cstdarg>
 #include <sstream>
 #include <AutoConnect/Json.hpp>
 #include <semaphore.h>
+#include <cstring>
+#include <arpa/inet.h>
 
 #include "AutoConnect/ThreadPool.h"
+#include "AutoConnect/PacketCapture.h"
+#include "AutoConnect/IoUring.h"
+#include "AutoConnect/PcapReader.h"
+#include "AutoConnect/AddressSet.h"
+#include "AutoConnect/ArpSweep.h"
+#include "AutoConnect/IgmpQuery.h"
+#include "AutoConnect/Netlink.h"
+#include "AutoConnect/FrameClassifier.h"
+#include "AutoConnect/VlanInterface.h"
+#include "AutoConnect/SlotMap.h"
+#include "AutoConnect/EthtoolCache.h"
+#include "AutoConnect/LinkClassifier.h"
 
 #define NUM_WORKER_THREADS 5
+// Seconds to listen for discovery traffic on a new adapter
+#define LISTEN_TIMEOUT_SECONDS 15
+// Upper bound for a listen window that is extended while the link is down
+#define LISTEN_MAX_SECONDS 60
+// Longest wait for the kernel to confirm a new host address before probing anyway
+#define ADDRESS_SETTLE_TIMEOUT_MS 500
+// Confidence added to an IPv4 candidate whose MAC also showed up in IPv6 discovery traffic
+#define IPV6_CORROBORATION_BONUS 10
+// Receives kept queued per adapter when capturing through io_uring in copy mode
+#define URING_RECEIVE_DEPTH 64
+
+namespace AutoConnect {
+    /**
+     * Discovery settings that can be selected at runtime. Filled from the command line in Main.cpp
+     */
+    struct DiscoveryOptions {
+        enum class EventLoop {
+            Epoll,   ///< One epoll instance for all capture sockets
+            IoUring, ///< Capture requests submitted through one io_uring
+        };
 
+        PacketCapture::Mode captureMode = PacketCapture::Mode::Auto;
+        EventLoop eventLoop = EventLoop::Epoll;
+        uint32_t batchSize = CAPTURE_BATCH_SIZE;
+        bool xdpNative = false;
+        std::map<std::string, uint32_t> fanoutWorkers; ///< Capture threads per adapter name. Unlisted adapters get one
+        AutoConnect::PacketCapture::Fanout fanoutMode = AutoConnect::PacketCapture::Fanout::Hash;
+        uint32_t busyPollUsecs = 0; ///< Busy poll the capture sockets for this long before sleeping, 0 to disable
+        uint32_t arpSweepRate = 0; ///< ARP requests per second of the active sweep, 0 to only listen passively
+        std::vector<AutoConnect::ArpSweep::Subnet> sweepSubnets; ///< Swept after the default and the adapter subnets
+        AutoConnect::IgmpQuery::Version igmpQuery = AutoConnect::IgmpQuery::Version::Off; ///< Sent when listening starts
+        std::vector<uint32_t> vendorOuis; ///< Candidates with a MAC from these vendors are probed first
+        bool ouiOnly = false;             ///< Only probe candidates with a matching vendor MAC
+        uint32_t listenSeconds = LISTEN_TIMEOUT_SECONDS; ///< Listen window after the link is up
+        uint32_t maxListenSeconds = LISTEN_MAX_SECONDS;  ///< Cap for a window extended while the link is down
+        bool stopOnCamera = true;                        ///< Stop listening on an adapter once a camera is confirmed
+        bool allowVirtual = false; ///< Also search behind veth, tun and tap interfaces, which are skipped by default
+        std::string replayFile;      ///< Feed frames from this pcap file instead of capturing on adapters
+        bool replayRealtime = false; ///< Keep the recorded spacing between frames instead of replaying at full speed
+    };
+}
 
 class AutoConnectLinux {
 
@@ -60,24 +117,129 @@ public:
         }
 
         bool supports = true;
+        AutoConnect::LinkClassifier::Kind kind = AutoConnect::LinkClassifier::Kind::Unknown;
         bool available = true;
         bool checkingForCamera = false;
-        std::vector<std::string> IPAddresses;
-        std::vector<std::string> searchedIPs;
+        bool linkUp = false;
+        uint32_t linkUpCount = 0; ///< Times the carrier came up while we watched the adapter
+        bool listening = false;
+        uint32_t hostAddress = 0; ///< Address checkForCamera gave the host on this adapter, network byte order
+        std::vector<AutoConnect::Candidate> candidates; ///< Waiting to be checked
+        std::vector<AutoConnect::Candidate> linkLocalHosts; ///< Hosts seen through MLD or neighbor advertisements
+        AutoConnect::AddressSet knownIPs;  ///< Every candidate seen on this adapter, checked or not
+        AutoConnect::AddressSet searchedIPs;
         std::string description;
         std::string ifName;
         uint32_t ifIndex = 0;
         std::vector<std::string> cameraIPAddresses;
         std::vector<std::string> cameraNameList;
+        std::vector<std::string> cameraInterfaces; ///< Interface each camera is reached through, a VLAN if tagged
+        std::vector<uint16_t> cameraVlans;         ///< VLAN of each camera, 0 if untagged
+        std::vector<nlohmann::json> cameraTimings; ///< How long each stage took from frame to confirmed camera
+
+        /** Capture counters summed over all listen sessions on this adapter */
+        struct Statistics {
+            uint64_t kernelPackets = 0; ///< Frames that passed the kernel filter
+            uint64_t kernelDrops = 0;   ///< Frames the kernel dropped before we could read them
+            uint64_t frames = 0;        ///< Frames read
+            uint64_t bytes = 0;
+            uint64_t classified = 0;    ///< Frames recognized as discovery traffic
+
+            [[nodiscard]] nlohmann::json toJson() const {
+                return {{"KernelPackets", kernelPackets},
+                        {"KernelDrops",   kernelDrops},
+                        {"Frames",        frames},
+                        {"Bytes",         bytes},
+                        {"Classified",    classified}};
+            }
+        } statistics;
+
+        bool isSearched(uint32_t ip) const {
+            return searchedIPs.contains(ip);
+        }
 
-        bool isSearched(const std::string &ip) {
-            for (const auto &searched: searchedIPs) {
-                if (searched == ip)
-                    return true;
+        /**
+         * Queues a candidate. An address that is already queued keeps its place but takes the higher confidence
+         * @return true if the address is new
+         */
+        bool addCandidate(AutoConnect::Candidate candidate) {
+            if (hasLinkLocal(candidate.mac))
+                candidate.confidence = corroborate(candidate.confidence);
+            if (knownIPs.insert(candidate.address)) {
+                candidates.emplace_back(candidate);
+                return true;
+            }
+            for (auto &queued: candidates) {
+                if (queued.address == candidate.address && queued.confidence < candidate.confidence)
+                    queued = candidate;
             }
             return false;
         }
 
+        /**
+         * Records a host seen through IPv6. Queued IPv4 candidates with the same MAC are moved up, since the same
+         * device announced itself in both families
+         * @return true if the MAC is new
+         */
+        bool addLinkLocal(const AutoConnect::Candidate &host) {
+            if (hasLinkLocal(host.mac))
+                return false;
+            linkLocalHosts.emplace_back(host);
+            for (auto &queued: candidates) {
+                if (memcmp(queued.mac, host.mac, sizeof(host.mac)) == 0)
+                    queued.confidence = corroborate(queued.confidence);
+            }
+            return true;
+        }
+
+        [[nodiscard]] bool hasLinkLocal(const uint8_t mac[6]) const {
+            return std::any_of(linkLocalHosts.begin(), linkLocalHosts.end(), [mac](const auto &host) {
+                return memcmp(host.mac, mac, sizeof(host.mac)) == 0;
+            });
+        }
+
+        static uint32_t corroborate(uint32_t confidence) {
+            return std::min<uint32_t>(confidence + IPV6_CORROBORATION_BONUS, 100);
+        }
+
+        [[nodiscard]] bool hasVendorCandidate(const std::vector<uint32_t> &vendorOuis) const {
+            return std::any_of(candidates.begin(), candidates.end(), [&vendorOuis](const auto &candidate) {
+                return std::find(vendorOuis.begin(), vendorOuis.end(),
+                                 AutoConnect::FrameClassifier::oui(candidate.mac)) != vendorOuis.end();
+            });
+        }
+
+        /**
+         * Removes and returns the queued candidate to probe next: vendor MAC matches first, then the highest
+         * confidence, then the oldest
+         */
+        AutoConnect::Candidate takeBestCandidate(const std::vector<uint32_t> &vendorOuis) {
+            auto rank = [&vendorOuis](const AutoConnect::Candidate &candidate) {
+                bool vendor = std::find(vendorOuis.begin(), vendorOuis.end(),
+                                        AutoConnect::FrameClassifier::oui(candidate.mac)) != vendorOuis.end();
+                return std::make_pair(vendor, candidate.confidence);
+            };
+            auto best = std::max_element(candidates.begin(), candidates.end(), [&rank](const auto &a, const auto &b) {
+                return rank(a) < rank(b);
+            });
+            auto candidate = *best;
+            candidates.erase(best);
+            return candidate;
+        }
+
+        [[nodiscard]] nlohmann::json linkLocalToJson() const {
+            nlohmann::json list = nlohmann::json::array();
+            for (const auto &host: linkLocalHosts) {
+                char address[INET6_ADDRSTRLEN];
+                char mac[18];
+                inet_ntop(AF_INET6, host.address6, address, sizeof(address));
+                snprintf(mac, sizeof(mac), "%02x:%02x:%02x:%02x:%02x:%02x", host.mac[0], host.mac[1], host.mac[2],
+                         host.mac[3], host.mac[4], host.mac[5]);
+                list.push_back({{"Address", address}, {"MAC", mac}});
+            }
+            return list;
+        }
+
         nlohmann::json sendAdapterResult() {
             nlohmann::json j;
             j["Name"] = ifName;
@@ -85,14 +247,25 @@ public:
             j["Description"] = description;
             j["AddressList"] = cameraIPAddresses;
             j["CameraNameList"] = cameraNameList;
+            j["InterfaceList"] = cameraInterfaces;
+            j["VlanList"] = cameraVlans;
+            j["TimingList"] = cameraTimings;
+            // Only counts closed listen sessions, publishStatistics refreshes it when the current one closes
+            j["Statistics"] = statistics.toJson();
+            j["LinkLocalList"] = linkLocalToJson();
 
             return j;
         }
     };
 
+    /** Refers to an entry of m_Adapters. Stops resolving once the kernel removed the link */
+    using AdapterHandle = AutoConnect::SlotMap<Adapter>::Handle;
+
     ~AutoConnectLinux() = default;
 
-    explicit AutoConnectLinux(bool enableIPC, bool logToConsole = false) {
+    explicit AutoConnectLinux(bool enableIPC, bool logToConsole = false,
+                              const AutoConnect::DiscoveryOptions &options = {}) : m_Options(options),
+                                                                                   m_VendorOuis(options.vendorOuis) {
         out = {
                 {"Name", "AutoConnect"},
                 {"Version", "v1.0.0"},
@@ -106,7 +279,12 @@ public:
         m_IsRunning = true;
         log("Started AutoConnect service");
 
+        if (!m_Options.replayFile.empty()) {
+            m_Pool->Push(AutoConnectLinux::replayCapture, this);
+            return;
+        }
         m_Pool->Push(AutoConnectLinux::adapterScan, this);
+        m_Pool->Push(AutoConnectLinux::listenOnAdapters, this);
         m_Pool->Push(AutoConnectLinux::runInternal, this, enableIPC);
 
     }
@@ -144,20 +322,147 @@ public:
             std::cout << "notifyStop: " << "Stop" << std::endl;
     }
 
+    /**
+     * Keeps m_Adapters in sync with the kernel's links. One RTM_GETLINK dump at start, then RTNLGRP_LINK
+     * notifications for added, removed and changed links. Also watches RTNLGRP_IPV4_IFADDR for other programs
+     * changing the addresses we gave our adapters
+     */
     static void adapterScan(void *ctx);
 
-    static void listenOnAdapter(void *ctx, Adapter *adapter);
+    /** A link as reported by rtnetlink */
+    struct LinkChange {
+        uint32_t ifIndex = 0;
+        std::string ifName;
+        bool linkUp = false;
+        bool removed = false;
+    };
+
+    /** An IPv4 address added to or removed from a link */
+    struct AddressChange {
+        uint32_t ifIndex = 0;
+        uint32_t address = 0; ///< Network byte order
+        uint8_t prefix = 0;
+        bool removed = false;
+    };
+
+    /** Everything one netlink read reported */
+    struct NetlinkChanges {
+        std::vector<LinkChange> links;
+        std::vector<AddressChange> addresses;
+    };
+
+    /**
+     * Merges link changes into m_Adapters. A removed link's entry is erased, so captures and probes still holding
+     * its handle notice. Links of a kind that is not searched are recorded once and never asked about over ethtool,
+     * for the others Ethernet support is taken from the ethtool cache
+     */
+    void applyLinkChanges(const std::vector<LinkChange> &changes, AutoConnect::LinkClassifier &classifier,
+                          AutoConnect::EthtoolCache &ethtool);
+
+    /** Logs address changes on adapters we configured that were not made by checkForCamera */
+    void applyAddressChanges(const std::vector<AddressChange> &changes);
+
+    /**
+     * Waits until the kernel reports an address on a link, instead of sleeping a fixed time after changing it
+     * @param netlink subscribed to RTNLGRP_IPV4_IFADDR before the address was set, so no notification is missed
+     * @param address network byte order
+     * @return false if the address did not show up within ADDRESS_SETTLE_TIMEOUT_MS
+     */
+    static bool waitForAddress(AutoConnect::Netlink &netlink, uint32_t ifIndex, uint32_t address, uint8_t prefix);
+
+    /**
+     * Queues an adapter for the capture loop in listenOnAdapters
+     */
+    static void listenOnAdapter(void *ctx, AdapterHandle adapter);
+
+    /**
+     * Event loop that captures on all listening adapters from a single thread.
+     * Every adapter's capture socket is registered with one epoll instance, or one io_uring if selected in the
+     * DiscoveryOptions, and frames are dispatched as they arrive.
+     */
+    static void listenOnAdapters(void *ctx);
+
+    static void checkForCamera(void *ctx, AdapterHandle handle);
 
-    static void checkForCamera(void *ctx, Adapter *adapter);
+    /**
+     * Runs the frames of a recorded capture through the same parser as live capture and reports the candidate
+     * addresses found and the parsing throughput. No adapters are configured and no cameras are probed.
+     */
+    static void replayCapture(void *ctx);
 
     void cleanUp();
 
 private:
+    struct Listener;
+
+    /**
+     * An io_uring request that belongs to a listener. Its address is the request's user data
+     */
+    struct UringRequest {
+        Listener *listener = nullptr;
+        std::vector<uint8_t> buffer;  ///< Receive buffer in copy mode
+        std::vector<uint8_t> control; ///< VLAN tag and timestamp of the received frame in copy mode
+        struct iovec iov{};
+        struct msghdr message{};
+        bool inFlight = false;
+    };
+
+    /**
+     * State of one capture on an adapter. Passed as context to the frame callback
+     */
+    struct Listener {
+        AutoConnectLinux *app = nullptr;
+        AdapterHandle adapter; ///< Resolve with m_Adapters.get() while holding m_AdaptersMutex
+        uint32_t ifIndex = 0;  ///< Interface the capture is bound to
+        std::string ifName;
+        AutoConnect::PacketCapture capture;
+        std::chrono::steady_clock::time_point started;
+        std::chrono::steady_clock::time_point deadline;
+        uint32_t linkUpCount = 0;
+        bool stopped = false; ///< Capture failed or the window was closed early
+        bool quiet = false;   ///< Do not log window changes, set on all but one socket of a fanout group
+        std::vector<UringRequest> requests;
+        uint64_t classified = 0; ///< Frames onFrame recognized as discovery traffic
+        /** Addresses already passed on to the adapter per kind of evidence, checked without locking */
+        AutoConnect::AddressSet seen[static_cast<size_t>(AutoConnect::Evidence::Count)];
+        std::shared_ptr<AutoConnect::ArpSweep> sweep; ///< Shared by the sockets of a fanout group
+
+        /** True while the kernel has not completed all io_uring requests of this listener */
+        [[nodiscard]] bool inFlight() const {
+            return std::any_of(requests.begin(), requests.end(), [](const auto &r) { return r.inFlight; });
+        }
+    };
+
+    /**
+     * One socket of a PACKET_FANOUT group, captured on by its own thread so a busy adapter can use several cores
+     */
+    struct FanoutWorker {
+        Listener listener;
+        std::thread thread;
+        std::chrono::steady_clock::time_point started;
+        std::chrono::steady_clock::time_point stopped;
+        std::atomic<bool> done = false;
+        uint64_t cpuMicros = 0; ///< CPU time used by the worker thread
+        bool drivesSweep = false; ///< Only one worker of a group sends the sweep, all of them recognize replies
+    };
+
+    /** The fanout sockets of one adapter */
+    struct FanoutGroup {
+        AdapterHandle adapter;
+        std::vector<std::unique_ptr<FanoutWorker>> workers;
+    };
+
     nlohmann::json out;
+    AutoConnect::DiscoveryOptions m_Options;
 
     std::unique_ptr<AutoConnect::ThreadPool> m_Pool;
-    std::vector<Adapter> m_Adapters;
+    // Keyed by interface index. Entries move when links are added, so only handles are kept outside the lock
+    AutoConnect::SlotMap<Adapter> m_Adapters;
     std::mutex m_AdaptersMutex;
+    std::vector<uint32_t> m_VendorOuis; ///< From the options plus those learned from confirmed cameras
+    std::vector<AdapterHandle> m_PendingListeners;
+    std::mutex m_ListenerMutex;
+    std::vector<std::unique_ptr<FanoutGroup>> m_FanoutGroups; ///< Only used by the listenOnAdapters thread
     std::mutex m_logQueueMutex;
     bool m_IsRunning = false;
     bool m_ListenOnAdapter = true;
@@ -168,6 +473,62 @@ private:
 
     static void runInternal(void *ctx, bool enableIPC);
 
+    static void onFrame(void *ctx, const AutoConnect::PacketCapture::Frame &frame);
+
+    bool startListening(Listener &listener, uint16_t fanoutGroup = 0);
+
+    void startFanout(AdapterHandle adapter, uint32_t workers);
+
+    /**
+     * Queues the adapter's entries in the kernel neighbor table as candidates. On a machine that talked to the
+     * camera before its address is usually still there
+     */
+    void seedFromNeighbors(AdapterHandle adapter);
+
+    /** Asks all multicast members on the listener's adapter to report, if enabled */
+    void sendIgmpQuery(const Listener &listener);
+
+    /** Starts the ARP sweep on an adapter if enabled. Sends the first burst right away */
+    std::shared_ptr<AutoConnect::ArpSweep> startSweep(const Listener &listener);
+
+    /**
+     * Sends the ARP requests of a listener's sweep that are due
+     * @return milliseconds until more requests are due or -1 if the listener is not sweeping
+     */
+    int advanceSweep(Listener &listener);
+
+    void runFanoutWorker(FanoutWorker *worker);
+
+    /**
+     * Joins the fanout groups whose workers have all stopped and logs their per socket rates
+     * @param wait join all groups, waiting for their workers to stop
+     */
+    void reapFanoutGroups(bool wait);
+
+    std::vector<std::unique_ptr<Listener>> startPendingListeners();
+
+    void listenWithEpoll();
+
+    bool listenWithIoUring();
+
+    /**
+     * Applies the listen window policy: closes the window once a camera is confirmed, extends it while the link is
+     * down and starts a new one when the carrier comes back up
+     * @return true if the listener should stop
+     */
+    bool listenExpired(Listener &listener, std::chrono::steady_clock::time_point now);
+
+    void logCaptureSummary(Listener &listener);
+
+    /** Adds the counters of a finished listener to its adapter */
+    AutoConnect::PacketCapture::Statistics recordStatistics(Listener &listener);
+
+    /**
+     * Logs the counters of an adapter and publishes them under "Statistics" in the output, next to the IPv6 hosts
+     * under "LinkLocal"
+     */
+    void publishStatistics(const Listener &listener);
+
     void reportAndExit(const char *msg);
 
     void sendMessage(caddr_t memPtr, sem_t *semPtr);
@@ -179,6 +540,9 @@ private:
     void setHostAddress(const std::string &adapterName, const std::string &hostAddress);
 
     void setMTU(const std::string &adapterName, int mtu = 7200);
+
+    /** Deletes the VLAN sub-interfaces that were created for a probe that found no camera */
+    void removeVlanLinks(const std::vector<AutoConnect::VlanInterface::Link> &links);
 };
 
 
@@ -0,0 +1,105 @@
+/**
+ * @file: AutoConnect/include/AutoConnect/EthtoolCache.h
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#ifndef AUTOCONNECT_ETHTOOLCACHE_H
+#define AUTOCONNECT_ETHTOOLCACHE_H
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// A cached interface is asked again after this long, even if no link event came in
+#define ETHTOOL_CACHE_TTL_SECONDS 60
+
+namespace AutoConnect {
+
+    /**
+     * Results of the ETHTOOL_GLINKSETTINGS request per interface. An interface is only asked again when it shows up
+     * under another name, when its carrier changed, since the speed is only known with a link, or when the entry is
+     * older than ETHTOOL_CACHE_TTL_SECONDS. All requests go over one socket.
+     * Not thread safe, meant to be owned by the thread that follows link changes.
+     */
+    class EthtoolCache {
+    public:
+        struct Info {
+            bool ethernet = false;   ///< The driver answers the link settings request
+            uint32_t speedMbps = 0;  ///< 0 while the link is down or the driver does not know
+            uint8_t duplex = 0;      ///< DUPLEX_HALF, DUPLEX_FULL or DUPLEX_UNKNOWN
+            uint8_t port = 0;        ///< PORT_TP, PORT_FIBRE and so on
+            std::vector<uint32_t> supportedModes; ///< ETHTOOL_LINK_MODE_* bitmap of the modes the device supports
+        };
+
+        EthtoolCache() = default;
+
+        ~EthtoolCache();
+
+        EthtoolCache(const EthtoolCache &) = delete;
+
+        EthtoolCache &operator=(const EthtoolCache &) = delete;
+
+        /**
+         * Cached settings of an interface, asked from the driver if there are none or they are stale
+         * @param linkUp current carrier state, a change since the last request refreshes the entry
+         */
+        const Info &lookup(uint32_t ifIndex, const std::string &ifName, bool linkUp);
+
+        /** Drops the entry of a removed interface */
+        void forget(uint32_t ifIndex);
+
+        /** ioctl() calls made so far */
+        [[nodiscard]] uint64_t requests() const {
+            return m_Requests;
+        }
+
+    private:
+        struct Entry {
+            std::string ifName;
+            bool linkUp = false;
+            std::chrono::steady_clock::time_point updated;
+            Info info;
+        };
+
+        void query(const std::string &ifName, Info &info);
+
+        int m_Fd = -1;
+        uint64_t m_Requests = 0;
+        std::map<uint32_t, Entry> m_Entries; ///< By interface index
+    };
+}
+
+#endif //AUTOCONNECT_ETHTOOLCACHE_H
@@ -0,0 +1,126 @@
+/**
+ * @file: AutoConnect/include/AutoConnect/FrameClassifier.h
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#ifndef AUTOCONNECT_FRAMECLASSIFIER_H
+#define AUTOCONNECT_FRAMECLASSIFIER_H
+
+#include <cstdint>
+
+// UDP port MultiSense cameras send their control replies and streams from
+#define MULTISENSE_CONTROL_PORT 9001
+// VLAN tags looked through in front of the EtherType. Double tagged (QinQ) frames are the most a switch port sends
+#define FRAME_MAX_VLAN_TAGS 2
+
+namespace AutoConnect {
+
+    /** What made an address a camera candidate */
+    enum class Evidence : uint8_t {
+        None,
+        Neighbor,      ///< Entry in the kernel neighbor table
+        ArpRequest,    ///< Sender of an ARP request
+        GratuitousArp, ///< Address announcement, cameras send these while booting
+        Igmp,          ///< IGMP membership report
+        ArpReply,      ///< Reply to our ARP sweep
+        MultiSenseUdp, ///< UDP from the MultiSense control port
+        Mld,           ///< IPv6 multicast listener report from a link-local address
+        NeighborAdvertisement, ///< ICMPv6 neighbor advertisement from a link-local address
+        Count,
+    };
+
+    /** An address that may belong to a camera */
+    struct Candidate {
+        uint32_t address = 0;        ///< IPv4 in network byte order, 0 for IPv6 evidence
+        uint8_t address6[16] = {};   ///< IPv6 link-local source for IPv6 evidence
+        uint8_t mac[6] = {};         ///< Link layer source
+        Evidence evidence = Evidence::None;
+        uint32_t confidence = 0;     ///< 0 to 100, see FrameClassifier::confidence()
+        uint16_t vlanId = 0;         ///< Outer VLAN the frame was tagged with, 0 if untagged
+        uint16_t vlanProtocol = 0;   ///< TPID of the outer tag, ETH_P_8021Q or ETH_P_8021AD
+        uint16_t innerVlanId = 0;    ///< Inner VLAN of a double tagged frame, 0 if there is none
+        uint64_t receivedNs = 0;     ///< CLOCK_REALTIME the kernel received the frame at
+        uint64_t classifiedNs = 0;   ///< CLOCK_REALTIME the frame was classified at
+    };
+
+    /** VLAN tag the kernel took off a frame before handing it over */
+    struct VlanTag {
+        uint16_t tci = 0;      ///< Priority and VLAN id
+        uint16_t protocol = 0; ///< TPID in host byte order, 0 if the kernel removed no tag
+    };
+
+    /**
+     * Decides whether a captured Ethernet frame is evidence of a camera and extracts the candidate address
+     */
+    class FrameClassifier {
+    public:
+        /**
+         * Looks through up to FRAME_MAX_VLAN_TAGS tags in the frame and records them with the candidate
+         * @param stripped tag the kernel already removed from the frame. It is the outermost one
+         * @param candidate filled in if the frame is evidence of a camera
+         * @return false for frames that tell nothing about cameras
+         */
+        static bool classify(const uint8_t *data, uint32_t length, Candidate &candidate, VlanTag stripped = {});
+
+        /**
+         * Finds the network layer of an Ethernet frame behind any VLAN tags, without copying
+         * @param tags filled with the tags in front of the EtherType, outermost first
+         * @param tagCount number of tags found
+         * @param protocol EtherType of the payload in host byte order
+         * @return offset of the payload, 0 if the frame is truncated or has more than FRAME_MAX_VLAN_TAGS tags
+         */
+        static uint32_t payloadOffset(const uint8_t *data, uint32_t length, VlanTag tags[FRAME_MAX_VLAN_TAGS],
+                                      uint32_t &tagCount, uint16_t &protocol);
+
+        /** How likely a sender is a camera given one piece of evidence */
+        static uint32_t confidence(Evidence evidence);
+
+        static const char *name(Evidence evidence);
+
+        /** True for evidence that carries an IPv6 link-local address instead of an IPv4 address */
+        static bool isIpv6(Evidence evidence) {
+            return evidence == Evidence::Mld || evidence == Evidence::NeighborAdvertisement;
+        }
+
+        /** Vendor part of a MAC address as 0xAABBCC */
+        static uint32_t oui(const uint8_t mac[6]) {
+            return (uint32_t) mac[0] << 16 | (uint32_t) mac[1] << 8 | mac[2];
+        }
+
+        /** Parses an OUI written as aa:bb:cc, aa-bb-cc or aabbcc */
+        static bool parseOui(const char *text, uint32_t &oui);
+    };
+}
+
+#endif //AUTOCONNECT_FRAMECLASSIFIER_H
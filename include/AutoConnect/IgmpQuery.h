@@ -0,0 +1,71 @@
+/**
+ * @file: AutoConnect/include/AutoConnect/IgmpQuery.h
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#ifndef AUTOCONNECT_IGMPQUERY_H
+#define AUTOCONNECT_IGMPQUERY_H
+
+#include <cstdint>
+#include <string>
+
+// Max response time announced in queries, in tenths of a second. Members answer after a random delay up to this
+#define IGMP_QUERY_RESPONSE_TIME_DS 10
+
+namespace AutoConnect {
+
+    /**
+     * IGMP general query to the all-hosts group. Every multicast member on the link answers with membership reports,
+     * so cameras show up right away instead of whenever they send an unsolicited report.
+     * The query is sent from 0.0.0.0 so it does not make us the elected querier on the link.
+     */
+    class IgmpQuery {
+    public:
+        enum class Version {
+            Off,
+            V2,
+            V3,
+        };
+
+        /**
+         * Sends one general query on an interface
+         * @param error set to the reason on failure
+         */
+        static bool send(uint32_t ifIndex, const std::string &ifName, Version version, std::string &error);
+
+        static const char *versionName(Version version);
+    };
+}
+
+#endif //AUTOCONNECT_IGMPQUERY_H
@@ -0,0 +1,138 @@
+/**
+ * @file: AutoConnect/include/AutoConnect/IoUring.h
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#ifndef AUTOCONNECT_IOURING_H
+#define AUTOCONNECT_IOURING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/socket.h>
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+
+namespace AutoConnect {
+
+    /**
+     * Minimal io_uring instance driven through the raw syscalls, so no liburing is needed.
+     * Requests are queued with the prepare functions and handed to the kernel in one go by submit().
+     * If the submission queue is full the queued requests are submitted right away to make room.
+     */
+    class IoUring {
+    public:
+        IoUring() = default;
+
+        ~IoUring();
+
+        IoUring(const IoUring &) = delete;
+
+        IoUring &operator=(const IoUring &) = delete;
+
+        /**
+         * Creates the ring and maps the submission and completion queues
+         * @return false if the kernel does not support io_uring or denies it. errorMessage() tells why
+         */
+        bool init(unsigned entries);
+
+        /** Wait until fd has any of the poll events set */
+        bool pollAdd(int fd, uint32_t events, uint64_t userData);
+
+        /** Receive a single datagram/frame from fd with its ancillary data. message must stay valid until completion */
+        bool recvMsg(int fd, struct msghdr *message, uint64_t userData);
+
+        /** Complete after ts has elapsed. ts must stay valid until the next submit() returns */
+        bool timeout(const struct __kernel_timespec *ts, uint64_t userData);
+
+        /** Cancel the request that was queued with target as user data */
+        bool cancel(uint64_t target, uint64_t userData);
+
+        /**
+         * Submits all queued requests and waits until at least waitNr completions are available
+         * @return number of submitted requests or -1 on error
+         */
+        int submit(unsigned waitNr);
+
+        /**
+         * Calls handler for every available completion and marks them as consumed
+         * @return number of completions handled
+         */
+        template<typename Handler>
+        unsigned forEachCompletion(Handler &&handler) {
+            unsigned head = *m_CqHead;
+            unsigned tail = __atomic_load_n(m_CqTail, __ATOMIC_ACQUIRE);
+            unsigned count = 0;
+            for (; head != tail; ++head, ++count) {
+                handler(m_Cqes[head & *m_CqMask]);
+                // Store the head as we go so handler may queue new requests without the CQ overflowing
+                __atomic_store_n(m_CqHead, head + 1, __ATOMIC_RELEASE);
+            }
+            return count;
+        }
+
+        [[nodiscard]] const std::string &errorMessage() const {
+            return m_Error;
+        }
+
+    private:
+        struct io_uring_sqe *getSqe();
+
+        void setError(const char *what);
+
+        int m_Fd = -1;
+        void *m_SqRing = nullptr;
+        void *m_CqRing = nullptr;
+        size_t m_SqRingSize = 0;
+        size_t m_CqRingSize = 0;
+        struct io_uring_sqe *m_Sqes = nullptr;
+        size_t m_SqesSize = 0;
+
+        unsigned *m_SqHead = nullptr;
+        unsigned *m_SqTail = nullptr;
+        unsigned *m_SqMask = nullptr;
+        unsigned *m_SqArray = nullptr;
+        unsigned m_SqEntries = 0;
+        unsigned m_SqeTail = 0; ///< Local tail, published to the kernel in submit()
+
+        unsigned *m_CqHead = nullptr;
+        unsigned *m_CqTail = nullptr;
+        unsigned *m_CqMask = nullptr;
+        struct io_uring_cqe *m_Cqes = nullptr;
+
+        std::string m_Error;
+    };
+}
+
+#endif //AUTOCONNECT_IOURING_H
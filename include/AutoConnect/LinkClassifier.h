@@ -0,0 +1,89 @@
+/**
+ * @file: AutoConnect/include/AutoConnect/LinkClassifier.h
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#ifndef AUTOCONNECT_LINKCLASSIFIER_H
+#define AUTOCONNECT_LINKCLASSIFIER_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace AutoConnect {
+
+    /**
+     * Tells what kind of device a network interface is from its attributes under /sys/class/net, without any ioctl.
+     * Interfaces that can not have a camera behind them, like loopback, bridges or the veth pairs of containers, are
+     * skipped before the ethtool check and before a capture is set up on them.
+     * Results are cached per interface index until the index shows up under another name.
+     */
+    class LinkClassifier {
+    public:
+        enum class Kind {
+            Unknown,     ///< sysfs is not mounted or the interface is gone. Left to the ethtool check
+            Ethernet,    ///< Ethernet with a bus device behind it, e.g. PCI
+            UsbEthernet, ///< Ethernet adapter on USB
+            Wireless,
+            Loopback,
+            Bridge,      ///< e.g. docker0
+            Bond,
+            Vlan,
+            Tun,         ///< tun or tap device
+            Virtual,     ///< Ethernet without a device behind it: veth, dummy, macvlan and the like
+            Other,       ///< Not Ethernet framed at all, e.g. tunnels or CAN
+        };
+
+        /** Kind of an interface, read from sysfs the first time the index is seen under this name */
+        Kind classify(uint32_t ifIndex, const std::string &ifName);
+
+        /** Drops the entry of a removed interface */
+        void forget(uint32_t ifIndex);
+
+        /**
+         * True if a camera can be searched for behind this kind of interface
+         * @param allowVirtual also accept veth, tun and tap devices, e.g. for testing against a network namespace
+         */
+        static bool isSearchable(Kind kind, bool allowVirtual);
+
+        static const char *name(Kind kind);
+
+    private:
+        static Kind read(const std::string &ifName);
+
+        std::map<uint32_t, std::pair<std::string, Kind>> m_Kinds; ///< Name and kind by interface index
+    };
+}
+
+#endif //AUTOCONNECT_LINKCLASSIFIER_H
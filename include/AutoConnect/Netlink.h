@@ -0,0 +1,126 @@
+/**
+ * @file: AutoConnect/include/AutoConnect/Netlink.h
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#ifndef AUTOCONNECT_NETLINK_H
+#define AUTOCONNECT_NETLINK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+// Receive buffer for netlink replies. Dumps are split over several reads if they do not fit
+#define NETLINK_BUFFER_SIZE (32 * 1024)
+
+namespace AutoConnect {
+
+    /**
+     * rtnetlink socket for dumping kernel tables and receiving change notifications
+     */
+    class Netlink {
+    public:
+        using MessageCallback = void (*)(void *ctx, const struct nlmsghdr *message);
+
+        Netlink() = default;
+
+        ~Netlink();
+
+        Netlink(const Netlink &) = delete;
+
+        Netlink &operator=(const Netlink &) = delete;
+
+        /**
+         * @param groups RTMGRP_* notification groups to subscribe to, 0 for none
+         */
+        bool open(uint32_t groups = 0);
+
+        void close();
+
+        /**
+         * Requests a dump and hands every reply message to callback until the dump is complete. Notifications that
+         * arrive in between are handed to callback as well.
+         * @param header family specific request header, e.g. struct ndmsg for RTM_GETNEIGH
+         */
+        bool dump(uint16_t type, const void *header, size_t length, MessageCallback callback, void *ctx);
+
+        /**
+         * Sends a request that changes a kernel table, e.g. RTM_NEWLINK, and waits for the kernel to acknowledge it
+         * @param flags NLM_F_CREATE, NLM_F_EXCL and the like, NLM_F_REQUEST and NLM_F_ACK are always set
+         * @param payload family specific header followed by its attributes, see addAttribute()
+         * @return false if the kernel refused, errorMessage() tells why
+         */
+        bool request(uint16_t type, uint16_t flags, const std::vector<uint8_t> &payload);
+
+        /**
+         * Hands the notifications that are already queued to callback without waiting
+         * @return number of messages delivered or -1 on error
+         */
+        int read(MessageCallback callback, void *ctx);
+
+        [[nodiscard]] int fd() const {
+            return m_Fd;
+        }
+
+        [[nodiscard]] const std::string &errorMessage() const {
+            return m_Error;
+        }
+
+        /**
+         * Indexes a list of route attributes by type. Types above max are skipped, missing ones stay nullptr
+         */
+        static void parseAttributes(const struct rtattr *attribute, int length, const struct rtattr **table, int max);
+
+        /**
+         * Appends a route attribute to a request payload
+         * @return offset of the attribute, pass it to endNested() once the attributes nested in it are appended
+         */
+        static size_t addAttribute(std::vector<uint8_t> &payload, uint16_t type, const void *data, size_t length);
+
+        /** Extends a nested attribute started with addAttribute() over everything appended since */
+        static void endNested(std::vector<uint8_t> &payload, size_t offset);
+
+    private:
+        void setError(const char *what);
+
+        int m_Fd = -1;
+        uint32_t m_Sequence = 0;
+        std::vector<uint8_t> m_Buffer;
+        std::string m_Error;
+    };
+}
+
+#endif //AUTOCONNECT_NETLINK_H
@@ -0,0 +1,253 @@
+/**
+ * @file: AutoConnect/include/AutoConnect/PacketCapture.h
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#ifndef AUTOCONNECT_PACKETCAPTURE_H
+#define AUTOCONNECT_PACKETCAPTURE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ctime>
+#include <sys/socket.h>
+#include <linux/if_packet.h>
+
+#include "AutoConnect/FrameClassifier.h"
+#include "AutoConnect/XdpCapture.h"
+
+// TPACKET_V3 ring geometry. Discovery frames are small so a few blocks per adapter is plenty
+#define CAPTURE_BLOCK_SIZE (1 << 16)
+#define CAPTURE_BLOCK_COUNT 8
+#define CAPTURE_FRAME_SIZE 2048
+// A block is handed to user space when it is full or after this many milliseconds
+#define CAPTURE_BLOCK_TIMEOUT_MS 50
+// Frames accepted by the socket filter are truncated to this length. Enough for Ethernet, IPv4 with options and the
+// IGMP, ARP or UDP header
+#define CAPTURE_SNAP_LENGTH 128
+// Default number of frames pulled per recvmmsg call in batch mode
+#define CAPTURE_BATCH_SIZE 32
+// Upper bound of frames handed over per read so one busy adapter cannot starve the others
+#define CAPTURE_MAX_FRAMES_PER_READ 256
+// Longest a blocking receive waits in busy poll mode before poll() returns to the caller
+#define CAPTURE_BUSY_POLL_TIMEOUT_MS 10
+// Ancillary data room per received message, enough for the PACKET_AUXDATA and SCM_TIMESTAMPNS messages
+#define CAPTURE_CONTROL_SIZE (CMSG_SPACE(sizeof(struct tpacket_auxdata)) + CMSG_SPACE(sizeof(struct timespec)))
+
+namespace AutoConnect {
+
+    /**
+     * Raw packet socket bound to a single interface.
+     * A classic BPF filter in the kernel drops all frames that are not relevant for discovery.
+     * By default frames are read in blocks from a PACKET_RX_RING (TPACKET_V3) shared with the kernel. If the kernel
+     * refuses the ring the socket is kept and frames are pulled in batches with recvmmsg() instead. All modes block
+     * in poll() so an idle adapter does not cost any CPU. With busy polling enabled the kernel polls the device queue
+     * for a short while before the caller is put to sleep, which trades some CPU for wakeup latency.
+     */
+    class PacketCapture {
+    public:
+        enum class Mode {
+            Auto,  ///< Ring if the kernel supports it, otherwise Batch
+            Ring,  ///< TPACKET_V3 memory mapped ring
+            Batch, ///< recvmmsg() into preallocated buffers
+            Copy,  ///< One recv() per frame
+            Xdp,   ///< AF_XDP sockets fed by an XDP program, IGMP only. Falls back to Auto if it cannot be attached
+        };
+
+        /** How the kernel spreads frames over the sockets of a PACKET_FANOUT group */
+        enum class Fanout {
+            Hash, ///< By flow hash, so all frames of one sender end up on the same socket
+            Cpu,  ///< By the CPU that received the frame
+        };
+
+        struct Config {
+            Mode mode = Mode::Auto;
+            uint32_t batchSize = CAPTURE_BATCH_SIZE; ///< Frames per recvmmsg() call in Batch mode
+            bool xdpNative = false; ///< Attach the XDP program in driver mode instead of generic (skb) mode
+            uint16_t fanoutGroup = 0; ///< Join this PACKET_FANOUT group, 0 for a standalone socket. Ignored in Xdp mode
+            Fanout fanoutMode = Fanout::Hash;
+            uint32_t busyPollUsecs = 0; ///< Busy poll the device queue this long before sleeping, 0 to disable
+        };
+
+        struct Frame {
+            const uint8_t *data = nullptr;
+            uint32_t length = 0;
+            VlanTag vlan; ///< Tag the kernel removed from the frame, see FrameClassifier::classify()
+            uint64_t timestampNs = 0; ///< CLOCK_REALTIME the kernel received the frame at, read time in Xdp mode
+        };
+
+        using FrameCallback = void (*)(void *ctx, const Frame &frame);
+
+        struct Statistics {
+            uint64_t frames = 0;        ///< Frames handed to the callback
+            uint64_t bytes = 0;         ///< Bytes handed to the callback, after truncation to the snap length
+            uint64_t kernelPackets = 0; ///< Frames the kernel accepted for the socket, including dropped ones
+            uint64_t kernelDrops = 0;   ///< Frames dropped because the socket buffer, ring or AF_XDP ring was full
+        };
+
+        PacketCapture() = default;
+
+        ~PacketCapture();
+
+        PacketCapture(const PacketCapture &) = delete;
+
+        PacketCapture &operator=(const PacketCapture &) = delete;
+
+        /**
+         * Opens the socket and binds it to the interface
+         * @param ifIndex interface index to capture on
+         * @param config how frames are read. A Ring request falls back to Batch if the ring cannot be set up
+         * @return false if no socket could be bound. errorMessage() tells why
+         */
+        bool open(uint32_t ifIndex, const Config &config);
+
+        void close();
+
+        /**
+         * Waits up to timeoutMs for frames and hands each received frame to callback.
+         * @return number of frames delivered or -1 on socket error
+         */
+        int poll(int timeoutMs, FrameCallback callback, void *ctx);
+
+        /**
+         * Hands the frames that are already queued to callback without waiting. Used when the caller
+         * multiplexes several captures with epoll.
+         * @return number of frames delivered or -1 on socket error
+         */
+        int read(FrameCallback callback, void *ctx);
+
+        /**
+         * Hands a frame that the caller received from fd() by other means, e.g. through io_uring, to callback
+         * and accounts for it in frames(). It is timestamped with the current time
+         */
+        void deliver(const uint8_t *data, uint32_t length, FrameCallback callback, void *ctx);
+
+        /**
+         * Like deliver(), for a frame the caller received with recvmsg() into the first iovec of message. The VLAN
+         * tag and the kernel timestamp are taken from its ancillary data, so give it CAPTURE_CONTROL_SIZE bytes
+         */
+        void deliver(struct msghdr &message, uint32_t length, FrameCallback callback, void *ctx);
+
+        /** Descriptor to wait on for frames */
+        [[nodiscard]] int fd() const {
+            return m_Xdp ? m_Xdp->fd() : m_Fd;
+        }
+
+        /** The mode frames are actually read with after open() */
+        [[nodiscard]] Mode mode() const {
+            return m_Mode;
+        }
+
+        /** Frames delivered since open() */
+        [[nodiscard]] uint64_t frames() const {
+            return m_Frames;
+        }
+
+        /**
+         * Counters since open(). Collects the kernel's drop counters, so call it before close()
+         */
+        Statistics statistics();
+
+        /** Receive syscalls made since open(). Always zero in Ring mode */
+        [[nodiscard]] uint64_t syscalls() const {
+            return m_Syscalls;
+        }
+
+        /** True if the kernel accepted the busy poll socket options */
+        [[nodiscard]] bool isBusyPolling() const {
+            return m_BusyPoll;
+        }
+
+        /** True if the kernel side discovery filter is attached */
+        [[nodiscard]] bool isFiltered() const {
+            return m_Filtered;
+        }
+
+        /** Reason for the last failure, also set when open() had to fall back from the ring */
+        [[nodiscard]] const std::string &errorMessage() const {
+            return m_Error;
+        }
+
+        static const char *modeName(Mode mode);
+
+        /** CLOCK_REALTIME in nanoseconds, the clock frame timestamps are taken from */
+        static uint64_t realtimeNs();
+
+    private:
+        bool attachFilter();
+
+        /** Fills in the VLAN tag and receive timestamp from the ancillary data of a received message */
+        static void parseControl(struct msghdr &message, Frame &frame);
+
+        bool joinFanout(uint16_t group, Fanout fanout);
+
+        bool enableBusyPoll(uint32_t usecs, uint32_t budget);
+
+        bool setupRing();
+
+        void setupBatch(uint32_t batchSize);
+
+        int readRing(FrameCallback callback, void *ctx);
+
+        int readBatch(FrameCallback callback, void *ctx, bool wait = false);
+
+        int readSocket(FrameCallback callback, void *ctx);
+
+        int readXdp(FrameCallback callback, void *ctx);
+
+        void setError(const char *what);
+
+        int m_Fd = -1;
+        Mode m_Mode = Mode::Auto;
+        bool m_Filtered = false;
+        bool m_BusyPoll = false;
+        uint8_t *m_Ring = nullptr;
+        size_t m_RingSize = 0;
+        uint32_t m_CurrentBlock = 0;
+        std::vector<uint8_t> m_Buffer;
+        std::vector<struct iovec> m_Iovecs;
+        std::vector<struct mmsghdr> m_Messages;
+        std::vector<uint8_t> m_Control; ///< Ancillary data of each message in Batch and Copy mode
+        std::unique_ptr<XdpCapture> m_Xdp;
+        uint64_t m_Frames = 0;
+        uint64_t m_Bytes = 0;
+        uint64_t m_Syscalls = 0;
+        uint64_t m_KernelPackets = 0;
+        uint64_t m_KernelDrops = 0;
+        std::string m_Error;
+    };
+}
+
+#endif //AUTOCONNECT_PACKETCAPTURE_H
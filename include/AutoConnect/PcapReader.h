@@ -0,0 +1,97 @@
+/**
+ * @file: AutoConnect/include/AutoConnect/PcapReader.h
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#ifndef AUTOCONNECT_PCAPREADER_H
+#define AUTOCONNECT_PCAPREADER_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace AutoConnect {
+
+    /**
+     * Reader for classic libpcap capture files (not pcapng), as written by tcpdump -w or Wireshark's "pcap" format.
+     * Handles both byte orders and microsecond or nanosecond timestamps. Ethernet captures are returned as is,
+     * Linux cooked captures (tcpdump -i any) are rewritten to an Ethernet header so the same parser can be used.
+     */
+    class PcapReader {
+    public:
+        struct Packet {
+            const uint8_t *data = nullptr;
+            uint32_t length = 0;
+            std::chrono::nanoseconds timestamp{0}; ///< Capture time since the epoch as recorded in the file
+        };
+
+        PcapReader() = default;
+
+        ~PcapReader();
+
+        PcapReader(const PcapReader &) = delete;
+
+        PcapReader &operator=(const PcapReader &) = delete;
+
+        /**
+         * Opens the file and reads the global header
+         * @return false if the file cannot be read or is not a supported capture. errorMessage() tells why
+         */
+        bool open(const std::string &path);
+
+        /**
+         * Reads the next packet. The data stays valid until the next call
+         * @return false at the end of the file or on a read error, in which case errorMessage() is set
+         */
+        bool next(Packet &packet);
+
+        [[nodiscard]] const std::string &errorMessage() const {
+            return m_Error;
+        }
+
+    private:
+        uint32_t toHost(uint32_t value) const;
+
+        FILE *m_File = nullptr;
+        bool m_Swapped = false;
+        bool m_Nanoseconds = false;
+        uint32_t m_LinkType = 0;
+        std::vector<uint8_t> m_Buffer;
+        std::string m_Error;
+    };
+}
+
+#endif //AUTOCONNECT_PCAPREADER_H
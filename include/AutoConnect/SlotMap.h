@@ -0,0 +1,146 @@
+/**
+ * @file: AutoConnect/include/AutoConnect/SlotMap.h
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#ifndef AUTOCONNECT_SLOTMAP_H
+#define AUTOCONNECT_SLOTMAP_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace AutoConnect {
+
+    /**
+     * Entries kept in one array and looked up by a 32-bit key, e.g. an interface index. Callers hold on to a Handle
+     * instead of a pointer. A handle carries the generation of its slot, so once the entry is erased the handle stops
+     * resolving even if the slot is reused for another entry.
+     * Pointers from get() are only valid until the next insert() or erase(), which may move the entries.
+     */
+    template<typename T>
+    class SlotMap {
+    public:
+        struct Handle {
+            uint32_t slot = 0;
+            uint32_t generation = 0; ///< 0 never refers to an entry
+
+            [[nodiscard]] bool valid() const {
+                return generation != 0;
+            }
+        };
+
+        /** Adds an entry under key. An entry already stored under key is erased first */
+        Handle insert(uint32_t key, T value) {
+            erase(find(key));
+            uint32_t slot;
+            if (!m_Free.empty()) {
+                slot = m_Free.back();
+                m_Free.pop_back();
+            } else {
+                slot = static_cast<uint32_t>(m_Slots.size());
+                m_Slots.emplace_back();
+            }
+            auto &entry = m_Slots[slot];
+            entry.value = std::move(value);
+            entry.key = key;
+            entry.used = true;
+            m_Keys[key] = slot;
+            return {slot, entry.generation};
+        }
+
+        /** Handle of the entry stored under key, an invalid handle if there is none */
+        [[nodiscard]] Handle find(uint32_t key) const {
+            auto it = m_Keys.find(key);
+            if (it == m_Keys.end())
+                return {};
+            return {it->second, m_Slots[it->second].generation};
+        }
+
+        /** The entry a handle refers to, nullptr if it was erased */
+        T *get(Handle handle) {
+            if (handle.slot >= m_Slots.size() || m_Slots[handle.slot].generation != handle.generation ||
+                !m_Slots[handle.slot].used)
+                return nullptr;
+            return &m_Slots[handle.slot].value;
+        }
+
+        const T *get(Handle handle) const {
+            return const_cast<SlotMap *>(this)->get(handle);
+        }
+
+        /** Removes an entry. Every handle to it stops resolving */
+        bool erase(Handle handle) {
+            if (get(handle) == nullptr)
+                return false;
+            auto &entry = m_Slots[handle.slot];
+            m_Keys.erase(entry.key);
+            entry.value = T();
+            entry.used = false;
+            // Skip 0 on wrap around so a recycled slot never matches a default constructed handle
+            if (++entry.generation == 0)
+                entry.generation = 1;
+            m_Free.emplace_back(handle.slot);
+            return true;
+        }
+
+        /** Calls function(Handle, T &) for every entry in slot order */
+        template<typename Function>
+        void forEach(Function &&function) {
+            for (uint32_t slot = 0; slot < m_Slots.size(); ++slot) {
+                if (m_Slots[slot].used)
+                    function(Handle{slot, m_Slots[slot].generation}, m_Slots[slot].value);
+            }
+        }
+
+        [[nodiscard]] size_t size() const {
+            return m_Keys.size();
+        }
+
+    private:
+        struct Slot {
+            T value;
+            uint32_t key = 0;
+            uint32_t generation = 1;
+            bool used = false;
+        };
+
+        std::vector<Slot> m_Slots;
+        std::vector<uint32_t> m_Free; ///< Slots of erased entries, reused before the array grows
+        std::unordered_map<uint32_t, uint32_t> m_Keys; ///< Key to slot
+    };
+}
+
+#endif //AUTOCONNECT_SLOTMAP_H
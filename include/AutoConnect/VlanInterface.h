@@ -0,0 +1,70 @@
+/**
+ * @file: AutoConnect/include/AutoConnect/VlanInterface.h
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#ifndef AUTOCONNECT_VLANINTERFACE_H
+#define AUTOCONNECT_VLANINTERFACE_H
+
+#include <cstdint>
+#include <string>
+
+namespace AutoConnect {
+
+    /**
+     * VLAN sub-interface used to reach a camera on a tagged switch port.
+     * An existing sub-interface with the right VLAN id is reused, otherwise one is created through rtnetlink.
+     */
+    class VlanInterface {
+    public:
+        struct Link {
+            uint32_t ifIndex = 0;
+            std::string ifName;
+            bool created = false; ///< Created by acquire(), the caller removes it again when it is not needed
+        };
+
+        /**
+         * Finds or creates the sub-interface of parent for a VLAN and brings it up
+         * @param protocol TPID of the tag in host byte order, ETH_P_8021Q or ETH_P_8021AD
+         * @return false on failure, error tells why
+         */
+        static bool acquire(uint32_t parentIndex, const std::string &parentName, uint16_t vlanId, uint16_t protocol,
+                            Link &link, std::string &error);
+
+        /** Deletes a sub-interface created by acquire() */
+        static bool remove(const Link &link, std::string &error);
+    };
+}
+
+#endif //AUTOCONNECT_VLANINTERFACE_H
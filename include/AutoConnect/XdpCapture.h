@@ -0,0 +1,147 @@
+/**
+ * @file: AutoConnect/include/AutoConnect/XdpCapture.h
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#ifndef AUTOCONNECT_XDPCAPTURE_H
+#define AUTOCONNECT_XDPCAPTURE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <linux/if_xdp.h>
+
+// Frames in the UMEM of each queue socket and size of its rings. Must be powers of two
+#define XDP_FRAME_COUNT 512
+#define XDP_FRAME_SIZE 2048
+#define XDP_RING_SIZE 512
+
+namespace AutoConnect {
+
+    /**
+     * AF_XDP capture on all receive queues of an interface.
+     * A small XDP program is attached to the interface that redirects IPv4 IGMP frames to an AF_XDP socket per queue
+     * and passes everything else on to the kernel untouched. Frames other than IGMP cannot be taken this way, since a
+     * redirected frame never reaches the kernel stack and ARP or LibMultiSense's UDP traffic must keep working.
+     * The queue sockets are grouped behind one epoll descriptor so the capture can be multiplexed like a single socket.
+     */
+    class XdpCapture {
+    public:
+        using FrameCallback = void (*)(void *ctx, const uint8_t *data, uint32_t length);
+
+        XdpCapture() = default;
+
+        ~XdpCapture();
+
+        XdpCapture(const XdpCapture &) = delete;
+
+        XdpCapture &operator=(const XdpCapture &) = delete;
+
+        /**
+         * Loads and attaches the XDP program and binds one AF_XDP socket per receive queue
+         * @param ifIndex interface to capture on
+         * @param native attach in driver mode with zero copy where supported, otherwise generic (skb) mode
+         * @return false on failure, errorMessage() tells why. Nothing stays attached in that case
+         */
+        bool open(uint32_t ifIndex, bool native);
+
+        void close();
+
+        /**
+         * Sets SO_BUSY_POLL and SO_PREFER_BUSY_POLL on every queue socket. read() then drives the device queue
+         * itself with a non-blocking receive call
+         * @param usecs time the kernel busy polls per call
+         * @param budget frames the driver may process per busy poll
+         * @return false if the kernel refused, errorMessage() tells why
+         */
+        bool enableBusyPoll(uint32_t usecs, uint32_t budget);
+
+        /**
+         * Hands every frame waiting in the receive rings to callback and gives the buffers back to the kernel
+         * @return number of frames delivered
+         */
+        int read(FrameCallback callback, void *ctx);
+
+        /** Frames the kernel could not hand to any of the queue sockets since open() */
+        uint64_t drops() const;
+
+        /** Descriptor that becomes readable when any queue has frames */
+        [[nodiscard]] int fd() const {
+            return m_EpollFd;
+        }
+
+        [[nodiscard]] const std::string &errorMessage() const {
+            return m_Error;
+        }
+
+    private:
+        struct Ring {
+            uint32_t *producer = nullptr;
+            uint32_t *consumer = nullptr;
+            void *descriptors = nullptr;
+            void *map = nullptr;
+            size_t mapSize = 0;
+        };
+
+        struct Queue {
+            int fd = -1;
+            uint8_t *umem = nullptr;
+            Ring fill;
+            Ring rx;
+        };
+
+        bool loadProgram(uint32_t queueCount);
+
+        bool openQueue(Queue &queue, uint32_t queueId, bool native);
+
+        bool setLinkProgram(int programFd, uint32_t flags);
+
+        static bool mapRing(int fd, Ring &ring, const struct xdp_ring_offset &offsets, size_t descriptorSize,
+                            off_t pageOffset);
+
+        void setError(const char *what);
+
+        uint32_t m_IfIndex = 0;
+        uint32_t m_AttachFlags = 0;
+        bool m_Attached = false;
+        bool m_BusyPoll = false;
+        int m_MapFd = -1;
+        int m_ProgramFd = -1;
+        int m_EpollFd = -1;
+        std::vector<Queue> m_Queues;
+        std::string m_Error;
+    };
+}
+
+#endif //AUTOCONNECT_XDPCAPTURE_H
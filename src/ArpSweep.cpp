@@ -0,0 +1,241 @@
+/**
+ * @file: AutoConnect/src/ArpSweep.cpp
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ifaddrs.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+
+#include "AutoConnect/ArpSweep.h"
+
+namespace AutoConnect {
+
+    struct __attribute__((packed)) ArpFrame {
+        struct ethhdr ethernet;
+        struct arphdr arp;
+        uint8_t senderHardware[ETH_ALEN];
+        uint32_t senderAddress;
+        uint8_t targetHardware[ETH_ALEN];
+        uint32_t targetAddress;
+    };
+
+    ArpSweep::~ArpSweep() {
+        close();
+    }
+
+    bool ArpSweep::open(uint32_t ifIndex, const std::string &ifName, const std::vector<Subnet> &extraSubnets,
+                        uint32_t rate) {
+        close();
+        m_Error.clear();
+        m_IfIndex = ifIndex;
+        m_Rate = std::max<uint32_t>(rate, 1);
+
+        // Protocol 0, this socket is only used for sending
+        if ((m_Fd = socket(PF_PACKET, SOCK_RAW, 0)) < 0) {
+            setError("socket");
+            return false;
+        }
+        struct ifreq ifr{};
+        strncpy(ifr.ifr_name, ifName.c_str(), IF_NAMESIZE - 1);
+        if (ioctl(m_Fd, SIOCGIFHWADDR, &ifr) == -1) {
+            setError("ioctl(SIOCGIFHWADDR)");
+            close();
+            return false;
+        }
+        if (ifr.ifr_hwaddr.sa_family != ARPHRD_ETHER) {
+            m_Error = "not an Ethernet adapter";
+            close();
+            return false;
+        }
+        memcpy(m_HardwareAddress, ifr.ifr_hwaddr.sa_data, ETH_ALEN);
+
+        Subnet defaultSubnet;
+        defaultSubnet.address = ntohl(inet_addr(ARP_SWEEP_DEFAULT_CAMERA_ADDRESS));
+        addSubnet(defaultSubnet, defaultSubnet.address);
+
+        struct ifaddrs *addresses = nullptr;
+        if (getifaddrs(&addresses) == 0) {
+            for (auto *ifa = addresses; ifa != nullptr; ifa = ifa->ifa_next) {
+                if (ifa->ifa_addr == nullptr || ifa->ifa_netmask == nullptr || ifa->ifa_addr->sa_family != AF_INET ||
+                    ifName != ifa->ifa_name)
+                    continue;
+                uint32_t address = reinterpret_cast<struct sockaddr_in *>(ifa->ifa_addr)->sin_addr.s_addr;
+                uint32_t mask = ntohl(reinterpret_cast<struct sockaddr_in *>(ifa->ifa_netmask)->sin_addr.s_addr);
+                if (m_SenderAddress == 0)
+                    m_SenderAddress = address;
+                Subnet own;
+                own.address = ntohl(address);
+                own.prefix = (uint32_t) __builtin_popcount(mask);
+                if (own.prefix < ARP_SWEEP_MAX_PREFIX)
+                    own.prefix = 24;
+                addSubnet(own);
+            }
+            freeifaddrs(addresses);
+        }
+        for (const auto &subnet: extraSubnets)
+            addSubnet(subnet);
+
+        // Never ask for our own address
+        m_Targets.erase(std::remove(m_Targets.begin(), m_Targets.end(), m_SenderAddress), m_Targets.end());
+        m_Next = 0;
+        m_Started = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    void ArpSweep::addSubnet(const Subnet &subnet, uint32_t first) {
+        uint32_t prefix = std::min<uint32_t>(subnet.prefix, 32);
+        uint32_t mask = prefix == 0 ? 0 : ~0u << (32 - prefix);
+        uint32_t network = subnet.address & mask;
+        uint32_t broadcast = network | ~mask;
+        // Network and broadcast addresses are not hosts unless the subnet is a point to point /31 or a /32
+        uint32_t low = prefix < 31 ? network + 1 : network;
+        uint32_t high = prefix < 31 ? broadcast - 1 : broadcast;
+        if (first < low || first > high)
+            first = low;
+
+        // Start at first and wrap around to the bottom of the subnet. Subnets may overlap, each host is asked once
+        for (uint64_t host = first; host <= high; ++host) {
+            if (m_Known.insert(htonl((uint32_t) host)))
+                m_Targets.emplace_back(htonl((uint32_t) host));
+        }
+        for (uint64_t host = low; host < first; ++host) {
+            if (m_Known.insert(htonl((uint32_t) host)))
+                m_Targets.emplace_back(htonl((uint32_t) host));
+        }
+    }
+
+    void ArpSweep::close() {
+        if (m_Fd >= 0) {
+            ::close(m_Fd);
+            m_Fd = -1;
+        }
+        m_Targets.clear();
+        m_Known.clear();
+        m_Next = 0;
+        m_SenderAddress = 0;
+    }
+
+    int ArpSweep::send() {
+        if (m_Fd < 0 || done())
+            return -1;
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - m_Started).count();
+        // Sending starts with a burst of one interval's worth so the default address is asked right away
+        auto perBurst = std::max<uint64_t>((uint64_t) m_Rate * ARP_SWEEP_INTERVAL_MS / 1000, 1);
+        auto due = std::min<uint64_t>((uint64_t) elapsed * m_Rate / 1000000 + perBurst, m_Targets.size());
+
+        ArpFrame frame{};
+        memset(frame.ethernet.h_dest, 0xff, ETH_ALEN);
+        memcpy(frame.ethernet.h_source, m_HardwareAddress, ETH_ALEN);
+        frame.ethernet.h_proto = htons(ETH_P_ARP);
+        frame.arp.ar_hrd = htons(ARPHRD_ETHER);
+        frame.arp.ar_pro = htons(ETH_P_IP);
+        frame.arp.ar_hln = ETH_ALEN;
+        frame.arp.ar_pln = 4;
+        frame.arp.ar_op = htons(ARPOP_REQUEST);
+        memcpy(frame.senderHardware, m_HardwareAddress, ETH_ALEN);
+        frame.senderAddress = m_SenderAddress;
+
+        struct sockaddr_ll addr{};
+        addr.sll_family = AF_PACKET;
+        addr.sll_protocol = htons(ETH_P_ARP);
+        addr.sll_ifindex = (int) m_IfIndex;
+        addr.sll_halen = ETH_ALEN;
+        memset(addr.sll_addr, 0xff, ETH_ALEN);
+
+        // Padded to the minimum Ethernet frame length, not all drivers do that for packet sockets
+        uint8_t buffer[ETH_ZLEN] = {};
+        for (; m_Next < due; ++m_Next) {
+            frame.targetAddress = m_Targets[m_Next];
+            memcpy(buffer, &frame, sizeof(frame));
+            if (sendto(m_Fd, buffer, sizeof(buffer), 0, (struct sockaddr *) &addr, sizeof(addr)) == -1) {
+                // The queue is full, try again with the next burst
+                if (errno == ENOBUFS || errno == EAGAIN)
+                    break;
+                setError("sendto");
+                m_Next = m_Targets.size();
+                return -1;
+            }
+        }
+        if (done())
+            return -1;
+        return ARP_SWEEP_INTERVAL_MS;
+    }
+
+    bool ArpSweep::isReply(const uint8_t *data, uint32_t length, uint32_t &address) const {
+        if (length < sizeof(ArpFrame))
+            return false;
+        const auto *frame = reinterpret_cast<const ArpFrame *>(data);
+        if (frame->ethernet.h_proto != htons(ETH_P_ARP) || frame->arp.ar_op != htons(ARPOP_REPLY) ||
+            frame->arp.ar_pro != htons(ETH_P_IP) || frame->arp.ar_hln != ETH_ALEN || frame->arp.ar_pln != 4)
+            return false;
+        // Only replies to us, not ones we overhear in promiscuous mode
+        if (memcmp(frame->targetHardware, m_HardwareAddress, ETH_ALEN) != 0)
+            return false;
+        address = frame->senderAddress;
+        return address != 0;
+    }
+
+    bool ArpSweep::parseSubnet(const std::string &text, Subnet &subnet) {
+        auto slash = text.find('/');
+        struct in_addr address{};
+        if (inet_pton(AF_INET, text.substr(0, slash).c_str(), &address) != 1)
+            return false;
+        subnet.address = ntohl(address.s_addr);
+        subnet.prefix = 32;
+        if (slash != std::string::npos) {
+            char *end = nullptr;
+            long prefix = strtol(text.c_str() + slash + 1, &end, 10);
+            if (end == text.c_str() + slash + 1 || *end != '\0' || prefix < 16 || prefix > 32)
+                return false;
+            subnet.prefix = (uint32_t) prefix;
+        }
+        return true;
+    }
+
+    void ArpSweep::setError(const char *what) {
+        m_Error = std::string(what) + ": " + strerror(errno);
+    }
+}
@@ -37,10 +37,11 @@
 // Created by magnus on 7/14/22.
 //
 
+#include <algorithm>
 #include <cstring>
 #include <linux/sockios.h>
+#include <linux/if_ether.h>
 #include <net/if.h>
-#include <linux/ethtool.h>
 #include <netinet/ip.h>
 #include <sys/ioctl.h>
 #include <arpa/inet.h>
@@ -49,6 +50,9 @@
 #include <sys/mman.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <poll.h>
 
 #include <sys/stat.h>
 #include <MultiSense/MultiSenseChannel.hh>
@@ -60,6 +64,77 @@
 #define AccessPerms 0777
 #define SemaphoreName "sem"
 
+// Per epoll instance busy poll settings, added in Linux 6.9
+#ifndef EPIOCSPARAMS
+struct epoll_params {
+    uint32_t busy_poll_usecs;
+    uint16_t busy_poll_budget;
+    uint8_t prefer_busy_poll;
+    uint8_t __pad;
+};
+#define EPIOCSPARAMS _IOW(0x8A, 0x01, struct epoll_params)
+#endif
+
+static std::string macToString(const uint8_t mac[6]) {
+    char text[18];
+    snprintf(text, sizeof(text), "%02x:%02x:%02x:%02x:%02x:%02x", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    return text;
+}
+
+// " on VLAN 100" or " on VLAN 100.200" for tagged candidates, empty otherwise
+static std::string vlanToString(const AutoConnect::Candidate &candidate) {
+    if (candidate.vlanId == 0)
+        return "";
+    std::string text = " on VLAN " + std::to_string(candidate.vlanId);
+    if (candidate.innerVlanId != 0)
+        text += "." + std::to_string(candidate.innerVlanId);
+    return text;
+}
+
+// Stage boundaries of one probe in CLOCK_REALTIME nanoseconds, the clock of the capture timestamps
+struct ProbeTiming {
+    uint64_t probeNs = 0;     ///< Candidate taken from the queue
+    uint64_t addressNs = 0;   ///< Interface chosen, host address about to change
+    uint64_t connectNs = 0;   ///< Address settled, connecting
+    uint64_t connectedNs = 0; ///< LibMultiSense returned
+
+    static double milliseconds(uint64_t from, uint64_t to) {
+        return to > from ? static_cast<double>(to - from) / 1e6 : 0.0;
+    }
+
+    [[nodiscard]] nlohmann::json toJson(const AutoConnect::Candidate &candidate) const {
+        return {
+                {"ReceivedNs",  candidate.receivedNs},
+                {"SocketMs",    milliseconds(candidate.receivedNs, candidate.classifiedNs)},
+                {"QueuedMs",    milliseconds(candidate.classifiedNs, probeNs)},
+                {"InterfaceMs", milliseconds(probeNs, addressNs)},
+                {"AddressMs",   milliseconds(addressNs, connectNs)},
+                {"ConnectMs",   milliseconds(connectNs, connectedNs)},
+                {"TotalMs",     milliseconds(candidate.receivedNs, connectedNs)},
+        };
+    }
+
+    [[nodiscard]] std::string summary(const AutoConnect::Candidate &candidate) const {
+        std::ostringstream text;
+        text.precision(3);
+        text << std::fixed << milliseconds(candidate.receivedNs, candidate.classifiedNs) << " ms in socket, "
+             << milliseconds(candidate.classifiedNs, probeNs) << " ms queued, " << milliseconds(probeNs, addressNs)
+             << " ms interface, " << milliseconds(addressNs, connectNs) << " ms address change, "
+             << milliseconds(connectNs, connectedNs) << " ms connect, "
+             << milliseconds(candidate.receivedNs, connectedNs) << " ms total";
+        return text.str();
+    }
+};
+
+// CPU time, user and system, used by the calling thread so far
+static uint64_t threadCpuMicros() {
+    struct rusage usage{};
+    if (getrusage(RUSAGE_THREAD, &usage) == -1)
+        return 0;
+    return (uint64_t) (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 + usage.ru_utime.tv_usec +
+           usage.ru_stime.tv_usec;
+}
+
 void AutoConnectLinux::reportAndExit(const char *msg) {
     log("%s ", msg);
     m_IsRunning = false;
@@ -158,22 +233,26 @@ void AutoConnectLinux::runInternal(void *ctx, bool enableIPC) {
         // Find a list of available adapters
         {
             std::scoped_lock<std::mutex> lock(app->m_AdaptersMutex);
-            for (auto &item: app->m_Adapters) {
+            app->m_Adapters.forEach([app](AdapterHandle handle, Adapter &item) {
                 if (item.supports && item.available) {
                     item.available = false;
-                    app->m_Pool->Push(AutoConnectLinux::listenOnAdapter, app, &item);
+                    item.listening = true;
+                    AutoConnectLinux::listenOnAdapter(app, handle);
                 }
-            }
+            });
         }
         // Add a task to check for cameras on an adapter
         {
             std::scoped_lock<std::mutex> lock(app->m_AdaptersMutex);
-            for (auto &item: app->m_Adapters) {
-                if (!item.IPAddresses.empty() && !item.checkingForCamera) {
-                    app->m_Pool->Push(AutoConnectLinux::checkForCamera, app, &item);
-                    item.checkingForCamera = true;
-                }
-            }
+            app->m_Adapters.forEach([app](AdapterHandle handle, Adapter &item) {
+                if (item.candidates.empty() || item.checkingForCamera)
+                    return;
+                // With -O, candidates from other vendors wait until a camera teaches us their prefix
+                if (app->m_Options.ouiOnly && !item.hasVendorCandidate(app->m_VendorOuis))
+                    return;
+                app->m_Pool->Push(AutoConnectLinux::checkForCamera, app, handle);
+                item.checkingForCamera = true;
+            });
         }
         if (enableIPC)
             app->sendMessage(memPtr, semPtr);
@@ -204,155 +283,1059 @@ void AutoConnectLinux::runInternal(void *ctx, bool enableIPC) {
     app->m_IsRunning = false;
 }
 
+// Reads an IPv4 address message, false if it is for another family
+static bool parseAddress(const struct nlmsghdr *message, AutoConnectLinux::AddressChange &change) {
+    auto *info = static_cast<const struct ifaddrmsg *>(NLMSG_DATA(message));
+    if (info->ifa_family != AF_INET)
+        return false;
+    const struct rtattr *attributes[IFA_MAX + 1];
+    AutoConnect::Netlink::parseAttributes(IFA_RTA(info), (int) IFA_PAYLOAD(message), attributes, IFA_MAX);
+    // IFA_ADDRESS is the peer on point to point links, IFA_LOCAL is always our own address
+    const struct rtattr *local = attributes[IFA_LOCAL] != nullptr ? attributes[IFA_LOCAL] : attributes[IFA_ADDRESS];
+    if (local == nullptr || RTA_PAYLOAD(local) < sizeof(uint32_t))
+        return false;
+    change.ifIndex = info->ifa_index;
+    memcpy(&change.address, RTA_DATA(local), sizeof(uint32_t));
+    change.prefix = info->ifa_prefixlen;
+    change.removed = message->nlmsg_type == RTM_DELADDR;
+    return true;
+}
+
+// Collects link and address messages from a dump or from notifications
+static void collectNetlinkChange(void *ctx, const struct nlmsghdr *message) {
+    auto *changes = static_cast<AutoConnectLinux::NetlinkChanges *>(ctx);
+    if (message->nlmsg_type == RTM_NEWADDR || message->nlmsg_type == RTM_DELADDR) {
+        AutoConnectLinux::AddressChange change;
+        if (parseAddress(message, change))
+            changes->addresses.emplace_back(change);
+        return;
+    }
+    if (message->nlmsg_type != RTM_NEWLINK && message->nlmsg_type != RTM_DELLINK)
+        return;
+    auto *info = static_cast<const struct ifinfomsg *>(NLMSG_DATA(message));
+    const struct rtattr *attributes[IFLA_MAX + 1];
+    AutoConnect::Netlink::parseAttributes(IFLA_RTA(info), (int) IFLA_PAYLOAD(message), attributes, IFLA_MAX);
+    if (attributes[IFLA_IFNAME] == nullptr)
+        return;
+    AutoConnectLinux::LinkChange change;
+    change.ifIndex = (uint32_t) info->ifi_index;
+    change.ifName = static_cast<const char *>(RTA_DATA(attributes[IFLA_IFNAME]));
+    change.linkUp = (info->ifi_flags & IFF_RUNNING) != 0;
+    change.removed = message->nlmsg_type == RTM_DELLINK;
+    changes->links.emplace_back(change);
+}
+
 void AutoConnectLinux::adapterScan(void *ctx) {
     auto *app = static_cast<AutoConnectLinux *>(ctx);
     app->log("Performing adapter scan");
+    AutoConnect::Netlink netlink;
+    if (!netlink.open(RTMGRP_LINK | RTMGRP_IPV4_IFADDR)) {
+        app->log("Cannot watch network links: ", netlink.errorMessage());
+        return;
+    }
+    AutoConnect::LinkClassifier classifier;
+    AutoConnect::EthtoolCache ethtool;
+    bool resync = true;
     while (app->m_ScanAdapters) {
-        // Get list of interfaces
-        std::vector<Adapter> adapters;
-        auto ifn = if_nameindex();
-        // If no interfaces. This turns to null if there is no interfaces for a few seconds
-        if (!ifn) {
-            app->log("if_nameindex error: ", strerror(errno));
-            continue;
+        NetlinkChanges changes;
+        // A full dump at start, and whenever notifications were lost because the socket buffer ran over
+        if (resync) {
+            struct ifinfomsg request{};
+            request.ifi_family = AF_UNSPEC;
+            if (!netlink.dump(RTM_GETLINK, &request, sizeof(request), collectNetlinkChange, &changes)) {
+                app->log("Failed to list network links: ", netlink.errorMessage());
+                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+                continue;
+            }
+            resync = false;
+        } else {
+            // Sleeps until a link changes, waking up now and then only to see if we should stop
+            struct pollfd pfd{};
+            pfd.fd = netlink.fd();
+            pfd.events = POLLIN;
+            if (poll(&pfd, 1, 500) <= 0)
+                continue;
+            if (netlink.read(collectNetlinkChange, &changes) < 0) {
+                app->log("Lost network link notifications: ", netlink.errorMessage(), ". Listing links again");
+                resync = true;
+            }
         }
-        auto fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_IP);
+        app->applyLinkChanges(changes.links, classifier, ethtool);
+        app->applyAddressChanges(changes.addresses);
+    }
+}
+
+void AutoConnectLinux::applyAddressChanges(const std::vector<AddressChange> &changes) {
+    std::scoped_lock<std::mutex> lock(m_AdaptersMutex);
+    for (const auto &change: changes) {
+        auto *adapter = m_Adapters.get(m_Adapters.find(change.ifIndex));
+        // Changes made while probing are our own
+        if (adapter == nullptr || adapter->checkingForCamera || adapter->hostAddress == 0)
+            continue;
+        std::string address = AutoConnect::AddressSet::toString(change.address);
+        if (change.removed && change.address == adapter->hostAddress)
+            log("Host address ", address, " was removed from: ", adapter->ifName, " by another program");
+        else if (!change.removed && change.address != adapter->hostAddress)
+            log("Another program added ", address, "/", (int) change.prefix, " to: ", adapter->ifName);
+    }
+}
 
+// Flags a matching RTM_NEWADDR in a dump or notification
+struct AddressWait {
+    AutoConnectLinux::AddressChange wanted;
+    bool found = false;
+};
 
-        for (auto i = ifn; i->if_name; ++i) {
-            struct {
-                __u32 link_mode_data[3 * 127]{};
-                struct ethtool_link_settings req{};
-            } ecmd{};
-            Adapter adapter(i->if_name, i->if_index);
+static void matchAddress(void *ctx, const struct nlmsghdr *message) {
+    auto *wait = static_cast<AddressWait *>(ctx);
+    AutoConnectLinux::AddressChange change;
+    if (message->nlmsg_type != RTM_NEWADDR || !parseAddress(message, change))
+        return;
+    if (change.ifIndex == wait->wanted.ifIndex && change.address == wait->wanted.address &&
+        change.prefix == wait->wanted.prefix)
+        wait->found = true;
+}
 
-            auto ifr = ifreq{};
-            std::strncpy(ifr.ifr_name, i->if_name, IF_NAMESIZE);
+bool AutoConnectLinux::waitForAddress(AutoConnect::Netlink &netlink, uint32_t ifIndex, uint32_t address,
+                                      uint8_t prefix) {
+    AddressWait wait;
+    wait.wanted.ifIndex = ifIndex;
+    wait.wanted.address = address;
+    wait.wanted.prefix = prefix;
+    // The address may have been in place already, which the kernel does not announce again
+    struct ifaddrmsg request{};
+    request.ifa_family = AF_INET;
+    if (!netlink.dump(RTM_GETADDR, &request, sizeof(request), matchAddress, &wait))
+        return false;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ADDRESS_SETTLE_TIMEOUT_MS);
+    while (!wait.found) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()).count();
+        if (left <= 0)
+            return false;
+        struct pollfd pfd{};
+        pfd.fd = netlink.fd();
+        pfd.events = POLLIN;
+        if (poll(&pfd, 1, (int) left) < 0 || netlink.read(matchAddress, &wait) < 0)
+            return false;
+    }
+    return true;
+}
 
-            ecmd.req.cmd = ETHTOOL_GLINKSETTINGS;
-            ifr.ifr_data = reinterpret_cast<char *>(&ecmd);
+void AutoConnectLinux::applyLinkChanges(const std::vector<LinkChange> &changes,
+                                        AutoConnect::LinkClassifier &classifier, AutoConnect::EthtoolCache &ethtool) {
+    // Outside the lock. Most notifications are answered from the caches without touching sysfs or the driver
+    std::vector<AutoConnect::LinkClassifier::Kind> kinds(changes.size());
+    std::vector<AutoConnect::EthtoolCache::Info> settings(changes.size());
+    for (size_t i = 0; i < changes.size(); ++i) {
+        if (changes[i].removed) {
+            classifier.forget(changes[i].ifIndex);
+            ethtool.forget(changes[i].ifIndex);
+            continue;
+        }
+        kinds[i] = classifier.classify(changes[i].ifIndex, changes[i].ifName);
+        if (AutoConnect::LinkClassifier::isSearchable(kinds[i], m_Options.allowVirtual))
+            settings[i] = ethtool.lookup(changes[i].ifIndex, changes[i].ifName, changes[i].linkUp);
+    }
 
-            // Check if interface is of type ethernet
-            if (ioctl(fd, SIOCETHTOOL, &ifr) == -1) {
-                adapter.supports = false;
+    std::vector<AdapterHandle> linkedUp;
+    {
+        std::scoped_lock<std::mutex> lock(m_AdaptersMutex);
+        for (size_t i = 0; i < changes.size(); ++i) {
+            const auto &change = changes[i];
+            auto handle = m_Adapters.find(change.ifIndex);
+            auto *adapter = m_Adapters.get(handle);
+            if (change.removed) {
+                // Listeners and probes holding the handle see it stop resolving and give up on the adapter
+                if (adapter != nullptr) {
+                    log("Adapter removed: ", adapter->ifName);
+                    m_Adapters.erase(handle);
+                }
+                continue;
+            }
+            if (adapter == nullptr) {
+                // A replugged adapter comes back under a new index and is treated as a new one
+                Adapter added(change.ifName.c_str(), change.ifIndex);
+                added.kind = kinds[i];
+                added.supports = settings[i].ethernet;
+                added.linkUp = change.linkUp;
+                m_Adapters.insert(change.ifIndex, added);
+                if (AutoConnect::LinkClassifier::isSearchable(added.kind, m_Options.allowVirtual))
+                    log("Found adapter: ", added.ifName, " index: ", added.ifIndex, " (",
+                        AutoConnect::LinkClassifier::name(added.kind), ") supports: ", added.supports);
+                else
+                    log("Skipping adapter: ", added.ifName, " index: ", added.ifIndex, " (",
+                        AutoConnect::LinkClassifier::name(added.kind), ")");
+                continue;
             }
-            // More ethernet checking
-            if (ecmd.req.link_mode_masks_nwords >= 0 || ecmd.req.cmd != ETHTOOL_GLINKSETTINGS) {
-                adapter.supports = false;
+            if (adapter->ifName != change.ifName) {
+                log("Adapter renamed: ", adapter->ifName, " to: ", change.ifName);
+                adapter->ifName = change.ifName;
             }
-            // Even more ethernet checking
-            ecmd.req.link_mode_masks_nwords = -ecmd.req.link_mode_masks_nwords;
-            if (ioctl(fd, SIOCETHTOOL, &ifr) == -1) {
-                adapter.supports = false;
+            adapter->kind = kinds[i];
+            adapter->supports = settings[i].ethernet;
+            if (change.linkUp && !adapter->linkUp && adapter->supports) {
+                if (settings[i].speedMbps != 0)
+                    log("Link up on adapter: ", adapter->ifName, " at ", settings[i].speedMbps, " Mb/s");
+                else
+                    log("Link up on adapter: ", adapter->ifName);
+                linkedUp.emplace_back(handle);
+                adapter->linkUpCount++;
+                // Listen again if the last window closed without finding a camera
+                if (!adapter->listening && !adapter->available && adapter->cameraIPAddresses.empty())
+                    adapter->available = true;
             }
+            adapter->linkUp = change.linkUp;
+        }
+    }
+    // A camera that was connected before is likely still in the neighbor table
+    for (auto handle: linkedUp)
+        seedFromNeighbors(handle);
+}
 
-            adapters.emplace_back(adapter);
+void AutoConnectLinux::listenOnAdapter(void *ctx, AdapterHandle adapter) {
+    auto *app = static_cast<AutoConnectLinux *>(ctx);
+    std::scoped_lock<std::mutex> lock(app->m_ListenerMutex);
+    app->m_PendingListeners.emplace_back(adapter);
+}
+
+void AutoConnectLinux::listenOnAdapters(void *ctx) {
+    auto *app = static_cast<AutoConnectLinux *>(ctx);
+    const auto &options = app->m_Options;
+    app->log("Listen policy: ", options.listenSeconds, " s window, extended up to ", options.maxListenSeconds,
+             " s while the link is down, restarted when the link comes up, ",
+             options.stopOnCamera ? "closed early once a camera is confirmed" : "kept open after a camera is found");
+    if (options.busyPollUsecs != 0)
+        app->log("Busy polling capture sockets for ", options.busyPollUsecs, " us before sleeping");
+    // Completions are not busy polled, the receive requests sleep on the socket like poll() does
+    if (options.eventLoop == AutoConnect::DiscoveryOptions::EventLoop::IoUring && options.busyPollUsecs != 0) {
+        app->log("Busy polling needs epoll, not using io_uring for adapter capture");
+    } else if (options.eventLoop == AutoConnect::DiscoveryOptions::EventLoop::IoUring) {
+        if (app->listenWithIoUring())
+            return;
+        app->log("Falling back to epoll for adapter capture");
+    }
+    app->listenWithEpoll();
+}
+
+std::vector<std::unique_ptr<AutoConnectLinux::Listener>> AutoConnectLinux::startPendingListeners() {
+    std::vector<AdapterHandle> pending;
+    {
+        std::scoped_lock<std::mutex> lock(m_ListenerMutex);
+        pending.swap(m_PendingListeners);
+    }
+    std::vector<std::unique_ptr<Listener>> started;
+    for (auto adapter: pending) {
+        std::string ifName;
+        {
+            std::scoped_lock<std::mutex> lock(m_AdaptersMutex);
+            auto *entry = m_Adapters.get(adapter);
+            if (entry == nullptr)
+                continue;
+            ifName = entry->ifName;
         }
-        if_freenameindex(ifn);
-        close(fd);
+        seedFromNeighbors(adapter);
+        auto workers = m_Options.fanoutWorkers.find(ifName);
+        if (workers != m_Options.fanoutWorkers.end() && workers->second > 1) {
+            if (m_Options.captureMode == AutoConnect::PacketCapture::Mode::Xdp)
+                log("Fanout is not used with XDP capture, it already spreads frames over the receive queues");
+            else {
+                startFanout(adapter, workers->second);
+                continue;
+            }
+        }
+        auto listener = std::make_unique<Listener>();
+        listener->app = this;
+        listener->adapter = adapter;
+        if (startListening(*listener)) {
+            listener->sweep = startSweep(*listener);
+            sendIgmpQuery(*listener);
+            started.emplace_back(std::move(listener));
+        }
+    }
+    return started;
+}
+
+void AutoConnectLinux::startFanout(AdapterHandle adapter, uint32_t workers) {
+    auto group = std::make_unique<FanoutGroup>();
+    group->adapter = adapter;
+    // Group ids are shared by the whole network namespace, the interface index keeps ours apart
+    uint16_t groupId;
+    {
+        std::scoped_lock<std::mutex> lock(m_AdaptersMutex);
+        auto *entry = m_Adapters.get(adapter);
+        if (entry == nullptr)
+            return;
+        groupId = static_cast<uint16_t>(entry->ifIndex & 0xffff);
+    }
+    std::shared_ptr<AutoConnect::ArpSweep> sweep;
+    for (uint32_t i = 0; i < workers; ++i) {
+        auto worker = std::make_unique<FanoutWorker>();
+        worker->listener.app = this;
+        worker->listener.adapter = adapter;
+        if (!startListening(worker->listener, groupId))
+            break;
+        worker->listener.quiet = i > 0;
+        // Start sending once the first socket is bound, replies that hash to later sockets are queued to the group
+        if (i == 0) {
+            sweep = startSweep(worker->listener);
+            worker->drivesSweep = true;
+            sendIgmpQuery(worker->listener);
+        }
+        worker->listener.sweep = sweep;
+        worker->started = std::chrono::steady_clock::now();
+        worker->thread = std::thread(&AutoConnectLinux::runFanoutWorker, this, worker.get());
+        group->workers.emplace_back(std::move(worker));
+    }
+    if (group->workers.empty())
+        return;
+    log("Capturing on adapter: ", group->workers.front()->listener.ifName, " with ", group->workers.size(),
+        " fanout sockets");
+    m_FanoutGroups.emplace_back(std::move(group));
+}
+
+void AutoConnectLinux::runFanoutWorker(FanoutWorker *worker) {
+    auto &listener = worker->listener;
+    while (m_ListenOnAdapter) {
+        auto now = std::chrono::steady_clock::now();
+        if (listenExpired(listener, now))
+            break;
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(listener.deadline - now).count();
+        int timeoutMs = static_cast<int>(std::min<int64_t>(remaining, 100));
+        if (worker->drivesSweep) {
+            int next = advanceSweep(listener);
+            if (next >= 0)
+                timeoutMs = std::min(timeoutMs, next);
+        }
+        if (listener.capture.poll(timeoutMs, AutoConnectLinux::onFrame, &listener) < 0) {
+            log("Capture failed on adapter: ", listener.ifName, " : ", listener.capture.errorMessage());
+            break;
+        }
+    }
+    worker->cpuMicros = threadCpuMicros();
+    worker->stopped = std::chrono::steady_clock::now();
+    worker->done = true;
+}
 
-        // Put into shared list
-        // If the name is new then insert it in the list
+void AutoConnectLinux::reapFanoutGroups(bool wait) {
+    for (auto it = m_FanoutGroups.begin(); it != m_FanoutGroups.end();) {
+        auto &workers = (*it)->workers;
+        if (!wait && !std::all_of(workers.begin(), workers.end(), [](const auto &w) { return w->done.load(); })) {
+            ++it;
+            continue;
+        }
+        uint64_t total = 0;
+        for (size_t i = 0; i < workers.size(); ++i) {
+            auto &worker = *workers[i];
+            worker.thread.join();
+            auto statistics = recordStatistics(worker.listener);
+            auto seconds = std::chrono::duration_cast<std::chrono::duration<double>>(
+                    worker.stopped - worker.started).count();
+            std::ostringstream rate;
+            rate.precision(1);
+            rate << std::fixed << (seconds > 0 ? static_cast<double>(statistics.frames) / seconds : 0.0);
+            log("Fanout socket ", i + 1, "/", workers.size(), " on adapter: ", worker.listener.ifName, ". ",
+                statistics.frames, " frames, ", rate.str(), " frames per second, ", statistics.kernelDrops,
+                " dropped, ", worker.cpuMicros / 1000, " ms CPU");
+            total += statistics.frames;
+        }
+        const auto &first = workers.front()->listener;
+        log("Stopped listening on adapter: ", first.ifName, ". ", total, " frames captured");
+        publishStatistics(first);
         {
-            std::scoped_lock<std::mutex> lock(app->m_AdaptersMutex);
-            for (const auto &adapter: adapters) {
-                bool exist = false;
-                for (const auto &shared: app->m_Adapters) {
-                    if (shared.ifName == adapter.ifName)
-                        exist = true;
-                }
-                if (!exist) {
-                    app->m_Adapters.emplace_back(adapter);
-                    app->log("Found adapter: ", adapter.ifName, " index: ", adapter.ifIndex, " supports: ",
-                             adapter.supports);
+            std::scoped_lock<std::mutex> lock(m_AdaptersMutex);
+            if (auto *adapter = m_Adapters.get((*it)->adapter))
+                adapter->listening = false;
+        }
+        it = m_FanoutGroups.erase(it);
+    }
+}
+
+void AutoConnectLinux::seedFromNeighbors(AdapterHandle adapter) {
+    uint32_t ifIndex;
+    {
+        std::scoped_lock<std::mutex> lock(m_AdaptersMutex);
+        auto *entry = m_Adapters.get(adapter);
+        if (entry == nullptr)
+            return;
+        ifIndex = entry->ifIndex;
+    }
+    AutoConnect::Netlink netlink;
+    if (!netlink.open()) {
+        log("Cannot read the neighbor table: ", netlink.errorMessage());
+        return;
+    }
+    struct Seed {
+        uint32_t ifIndex;
+        std::vector<AutoConnect::Candidate> candidates;
+    } seed{ifIndex, {}};
+    struct ndmsg request{};
+    request.ndm_family = AF_INET;
+    request.ndm_ifindex = (int) ifIndex;
+    bool dumped = netlink.dump(RTM_GETNEIGH, &request, sizeof(request), [](void *ctx, const struct nlmsghdr *message) {
+        auto *seed = static_cast<Seed *>(ctx);
+        if (message->nlmsg_type != RTM_NEWNEIGH)
+            return;
+        auto *neighbor = static_cast<const struct ndmsg *>(NLMSG_DATA(message));
+        // Older kernels dump all interfaces regardless of ndm_ifindex
+        if (neighbor->ndm_family != AF_INET || neighbor->ndm_ifindex != (int) seed->ifIndex ||
+            !(neighbor->ndm_state & (NUD_REACHABLE | NUD_STALE | NUD_DELAY | NUD_PROBE | NUD_PERMANENT)))
+            return;
+        const struct rtattr *attributes[NDA_MAX + 1];
+        AutoConnect::Netlink::parseAttributes(
+                reinterpret_cast<const struct rtattr *>(reinterpret_cast<const uint8_t *>(neighbor) +
+                                                        NLMSG_ALIGN(sizeof(struct ndmsg))),
+                (int) (message->nlmsg_len - NLMSG_LENGTH(sizeof(struct ndmsg))), attributes, NDA_MAX);
+        if (attributes[NDA_DST] != nullptr && RTA_PAYLOAD(attributes[NDA_DST]) == sizeof(uint32_t)) {
+            AutoConnect::Candidate candidate;
+            memcpy(&candidate.address, RTA_DATA(attributes[NDA_DST]), sizeof(candidate.address));
+            if (attributes[NDA_LLADDR] != nullptr && RTA_PAYLOAD(attributes[NDA_LLADDR]) == sizeof(candidate.mac))
+                memcpy(candidate.mac, RTA_DATA(attributes[NDA_LLADDR]), sizeof(candidate.mac));
+            candidate.evidence = AutoConnect::Evidence::Neighbor;
+            candidate.confidence = AutoConnect::FrameClassifier::confidence(candidate.evidence);
+            candidate.receivedNs = candidate.classifiedNs = AutoConnect::PacketCapture::realtimeNs();
+            seed->candidates.emplace_back(candidate);
+        }
+    }, &seed);
+    if (!dumped) {
+        log("Cannot read the neighbor table: ", netlink.errorMessage());
+        return;
+    }
+
+    std::scoped_lock<std::mutex> lock(m_AdaptersMutex);
+    auto *entry = m_Adapters.get(adapter);
+    if (entry == nullptr)
+        return;
+    for (const auto &candidate: seed.candidates) {
+        if (entry->addCandidate(candidate))
+            log("Got address ", AutoConnect::AddressSet::toString(candidate.address), " On adapter: ", entry->ifName,
+                " from neighbor table");
+    }
+}
+
+void AutoConnectLinux::sendIgmpQuery(const Listener &listener) {
+    if (m_Options.igmpQuery == AutoConnect::IgmpQuery::Version::Off)
+        return;
+    std::string error;
+    if (AutoConnect::IgmpQuery::send(listener.ifIndex, listener.ifName, m_Options.igmpQuery, error))
+        log("Sent ", AutoConnect::IgmpQuery::versionName(m_Options.igmpQuery), " general query on adapter: ",
+            listener.ifName);
+    else
+        log("Failed to send IGMP query on adapter: ", listener.ifName, " : ", error);
+}
+
+std::shared_ptr<AutoConnect::ArpSweep> AutoConnectLinux::startSweep(const Listener &listener) {
+    if (m_Options.arpSweepRate == 0)
+        return nullptr;
+    // The XDP program only hands IGMP to user space, replies would go to the kernel stack only
+    if (listener.capture.mode() == AutoConnect::PacketCapture::Mode::Xdp) {
+        log("ARP sweep is not available with XDP capture on adapter: ", listener.ifName);
+        return nullptr;
+    }
+    auto sweep = std::make_shared<AutoConnect::ArpSweep>();
+    if (!sweep->open(listener.ifIndex, listener.ifName, m_Options.sweepSubnets, m_Options.arpSweepRate)) {
+        log("Cannot sweep adapter: ", listener.ifName, " with ARP: ", sweep->errorMessage());
+        return nullptr;
+    }
+    log("Sweeping ", sweep->targets(), " addresses with ARP on adapter: ", listener.ifName, " at ",
+        m_Options.arpSweepRate, " requests per second from ", AutoConnect::AddressSet::toString(sweep->senderAddress()));
+    sweep->send();
+    return sweep;
+}
+
+int AutoConnectLinux::advanceSweep(Listener &listener) {
+    auto &sweep = listener.sweep;
+    if (!sweep || sweep->done())
+        return -1;
+    int next = sweep->send();
+    if (sweep->done()) {
+        if (!sweep->errorMessage().empty())
+            log("ARP sweep failed on adapter: ", listener.ifName, " : ", sweep->errorMessage());
+        else
+            log("ARP sweep finished on adapter: ", listener.ifName, ". ", sweep->sent(), " requests sent");
+    }
+    return next;
+}
+
+void AutoConnectLinux::listenWithEpoll() {
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        log("epoll_create1 failed, cannot listen on adapters: ", strerror(errno));
+        return;
+    }
+    if (m_Options.busyPollUsecs != 0) {
+        // epoll_wait() then polls the device queues of the registered sockets before it sleeps
+        struct epoll_params params{};
+        params.busy_poll_usecs = m_Options.busyPollUsecs;
+        params.busy_poll_budget = static_cast<uint16_t>(std::min<uint32_t>(m_Options.batchSize, UINT16_MAX));
+        params.prefer_busy_poll = 1;
+        if (ioctl(epollFd, EPIOCSPARAMS, &params) == -1)
+            log("epoll busy poll not available: ", strerror(errno), ". Only the capture sockets busy poll");
+    }
+    uint64_t cpuStart = threadCpuMicros();
+    uint64_t wakeups = 0;
+
+    std::vector<std::unique_ptr<Listener>> listeners;
+    while (m_ListenOnAdapter) {
+        // Pick up adapters queued by runInternal
+        for (auto &listener: startPendingListeners()) {
+            struct epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.ptr = listener.get();
+            if (epoll_ctl(epollFd, EPOLL_CTL_ADD, listener->capture.fd(), &event) == -1) {
+                log("Failed to register adapter ", listener->ifName, " with epoll: ", strerror(errno));
+                continue;
+            }
+            listeners.emplace_back(std::move(listener));
+        }
+
+        // Sleep until the nearest listen deadline or sweep burst, but wake up regularly to see new adapters and
+        // stop requests
+        auto now = std::chrono::steady_clock::now();
+        int timeoutMs = 100;
+        for (const auto &listener: listeners) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(listener->deadline - now).count();
+            timeoutMs = std::clamp(static_cast<int>(remaining), 0, timeoutMs);
+            int next = advanceSweep(*listener);
+            if (next >= 0)
+                timeoutMs = std::min(timeoutMs, next);
+        }
+
+        struct epoll_event events[16];
+        int ready = epoll_wait(epollFd, events, 16, timeoutMs);
+        if (ready < 0 && errno != EINTR) {
+            log("epoll_wait failed: ", strerror(errno));
+            break;
+        }
+        if (ready > 0)
+            ++wakeups;
+        for (int i = 0; i < ready; ++i) {
+            auto *listener = static_cast<Listener *>(events[i].data.ptr);
+            if (listener->capture.read(AutoConnectLinux::onFrame, listener) < 0) {
+                log("Capture failed on adapter: ", listener->ifName, " : ",
+                    listener->capture.errorMessage());
+                listener->stopped = true;
+            }
+        }
 
+        reapFanoutGroups(false);
+        // Close listeners whose time is up
+        now = std::chrono::steady_clock::now();
+        for (auto it = listeners.begin(); it != listeners.end();) {
+            if (listenExpired(**it, now)) {
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, (*it)->capture.fd(), nullptr);
+                logCaptureSummary(**it);
+                it = listeners.erase(it);
+                // Report the cost of each busy period, the loop itself may run until the program is stopped
+                if (listeners.empty()) {
+                    uint64_t cpu = threadCpuMicros();
+                    log("Capture loop used ", (cpu - cpuStart) / 1000, " ms CPU and woke up ", wakeups,
+                        " times for frames");
+                    cpuStart = cpu;
+                    wakeups = 0;
                 }
+            } else {
+                ++it;
             }
         }
-        // Don't update too fast
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
     }
+    listeners.clear();
+    reapFanoutGroups(true);
+    close(epollFd);
 }
 
-void AutoConnectLinux::listenOnAdapter(void *ctx, Adapter *adapter) {
-    auto *app = static_cast<AutoConnectLinux *>(ctx);
-    // Submit request for a socket descriptor to look up interface.
-    app->log("Configuring adapter: ", adapter->ifName);
+// user_data values of io_uring requests that do not belong to a listener
+#define URING_TICK_TAG 0
+#define URING_CANCEL_TAG 1
+
+bool AutoConnectLinux::listenWithIoUring() {
+    AutoConnect::IoUring ring;
+    if (!ring.init(128)) {
+        log("io_uring not available: ", ring.errorMessage());
+        return false;
+    }
+    log("Capturing on adapters through io_uring");
+
+    // Ring and batch captures wait for readiness with a poll request and then read from the mapped ring or with
+    // recvmmsg. Copy captures keep several recvmsg requests queued in the kernel and get one frame with each
+    // completion.
+    auto arm = [&ring](UringRequest &request) {
+        auto &capture = request.listener->capture;
+        auto userData = reinterpret_cast<uint64_t>(&request);
+        if (capture.mode() == AutoConnect::PacketCapture::Mode::Copy) {
+            request.message.msg_controllen = request.control.size();
+            request.inFlight = ring.recvMsg(capture.fd(), &request.message, userData);
+        } else {
+            request.inFlight = ring.pollAdd(capture.fd(), POLLIN, userData);
+        }
+        return request.inFlight;
+    };
+    auto start = [&arm](Listener &listener) {
+        size_t depth = listener.capture.mode() == AutoConnect::PacketCapture::Mode::Copy ? URING_RECEIVE_DEPTH : 1;
+        listener.requests = std::vector<UringRequest>(depth);
+        for (auto &request: listener.requests) {
+            request.listener = &listener;
+            if (listener.capture.mode() == AutoConnect::PacketCapture::Mode::Copy) {
+                // A plain receive would lose the stripped VLAN tag and the kernel timestamp
+                request.buffer.resize(CAPTURE_FRAME_SIZE);
+                request.control.resize(CAPTURE_CONTROL_SIZE);
+                request.iov = {request.buffer.data(), request.buffer.size()};
+                request.message.msg_iov = &request.iov;
+                request.message.msg_iovlen = 1;
+                request.message.msg_control = request.control.data();
+            }
+            if (!arm(request))
+                return false;
+        }
+        return true;
+    };
+    auto cancel = [&ring](Listener &listener) {
+        for (auto &request: listener.requests) {
+            if (request.inFlight)
+                ring.cancel(reinterpret_cast<uint64_t>(&request), URING_CANCEL_TAG);
+        }
+    };
+
+    std::vector<std::unique_ptr<Listener>> listeners;
+    // Expired listeners stay alive until the kernel has completed all their requests
+    std::vector<std::unique_ptr<Listener>> closing;
+    auto finishClosing = [&closing](Listener *listener) {
+        auto it = std::find_if(closing.begin(), closing.end(),
+                               [listener](const auto &item) { return item.get() == listener; });
+        if (it == closing.end())
+            return false;
+        if (!(*it)->inFlight())
+            closing.erase(it);
+        return true;
+    };
+
+    struct __kernel_timespec tick{};
+    tick.tv_nsec = 100 * 1000 * 1000;
+    bool tickArmed = false;
+    bool failed = false;
+
+    while (m_ListenOnAdapter && !failed) {
+        // Pick up adapters queued by runInternal
+        for (auto &listener: startPendingListeners()) {
+            if (!start(*listener)) {
+                log("Failed to queue capture on adapter ", listener->ifName, " : ", ring.errorMessage());
+                cancel(*listener);
+                if (listener->inFlight())
+                    closing.emplace_back(std::move(listener));
+                continue;
+            }
+            listeners.emplace_back(std::move(listener));
+        }
+        // Wake up regularly to see new adapters, deadlines, stop requests and sweep bursts
+        if (!tickArmed) {
+            int tickMs = 100;
+            for (const auto &listener: listeners) {
+                int next = advanceSweep(*listener);
+                if (next >= 0)
+                    tickMs = std::min(tickMs, next);
+            }
+            tick.tv_nsec = static_cast<long>(tickMs) * 1000 * 1000;
+            tickArmed = ring.timeout(&tick, URING_TICK_TAG);
+        }
+
+        // Everything queued since the last iteration goes to the kernel in a single syscall
+        if (ring.submit(1) < 0) {
+            log("io_uring submit failed: ", ring.errorMessage());
+            failed = true;
+            break;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        ring.forEachCompletion([&](const struct io_uring_cqe &cqe) {
+            if (cqe.user_data == URING_TICK_TAG) {
+                tickArmed = false;
+                return;
+            }
+            if (cqe.user_data == URING_CANCEL_TAG)
+                return;
+
+            auto *request = reinterpret_cast<UringRequest *>(cqe.user_data);
+            auto *listener = request->listener;
+            request->inFlight = false;
+            if (finishClosing(listener))
+                return;
+
+            if (cqe.res < 0) {
+                errno = -cqe.res;
+                log("Capture failed on adapter: ", listener->ifName, " : ", strerror(errno));
+                listener->stopped = true;
+                return;
+            }
+            if (listener->capture.mode() == AutoConnect::PacketCapture::Mode::Copy) {
+                listener->capture.deliver(request->message, static_cast<uint32_t>(cqe.res),
+                                          AutoConnectLinux::onFrame, listener);
+            } else if (listener->capture.read(AutoConnectLinux::onFrame, listener) < 0) {
+                log("Capture failed on adapter: ", listener->ifName, " : ",
+                    listener->capture.errorMessage());
+                listener->stopped = true;
+                return;
+            }
+            if (!listener->stopped && !arm(*request)) {
+                log("Failed to queue capture on adapter ", listener->ifName, " : ", ring.errorMessage());
+                failed = true;
+            }
+        });
+
+        reapFanoutGroups(false);
+        // Close listeners whose time is up
+        now = std::chrono::steady_clock::now();
+        for (auto it = listeners.begin(); it != listeners.end();) {
+            if (listenExpired(**it, now)) {
+                logCaptureSummary(**it);
+                cancel(**it);
+                if ((*it)->inFlight())
+                    closing.emplace_back(std::move(*it));
+                it = listeners.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // Fanout workers do not use the ring, after a failure the epoll loop keeps reaping them
+    reapFanoutGroups(!failed);
+    // The kernel may still write into the receive buffers, so wait for all outstanding requests before returning
+    for (auto &listener: listeners) {
+        if (failed) {
+            // Hand the adapter back to runInternal so the epoll loop captures on it again
+            logCaptureSummary(*listener);
+            std::scoped_lock<std::mutex> lock(m_AdaptersMutex);
+            if (auto *adapter = m_Adapters.get(listener->adapter))
+                adapter->available = adapter->cameraIPAddresses.empty();
+        }
+        cancel(*listener);
+        if (listener->inFlight())
+            closing.emplace_back(std::move(listener));
+    }
+    listeners.clear();
+    while (!closing.empty() && ring.submit(1) >= 0) {
+        ring.forEachCompletion([&](const struct io_uring_cqe &cqe) {
+            if (cqe.user_data == URING_TICK_TAG || cqe.user_data == URING_CANCEL_TAG)
+                return;
+            auto *request = reinterpret_cast<UringRequest *>(cqe.user_data);
+            request->inFlight = false;
+            finishClosing(request->listener);
+        });
+    }
+    if (!closing.empty()) {
+        // Without a working ring the receive buffers cannot be released safely, keep them for the process lifetime
+        log("io_uring requests still outstanding, leaking ", closing.size(), " capture buffers");
+        for (auto &listener: closing)
+            listener.release();
+    }
+    return !failed;
+}
+
+bool AutoConnectLinux::listenExpired(Listener &listener, std::chrono::steady_clock::time_point now) {
+    if (listener.stopped)
+        return true;
+    bool cameraFound;
+    bool linkUp;
+    uint32_t linkUpCount;
+    bool gone;
+    {
+        std::scoped_lock<std::mutex> lock(m_AdaptersMutex);
+        auto *adapter = m_Adapters.get(listener.adapter);
+        gone = adapter == nullptr;
+        cameraFound = !gone && !adapter->cameraIPAddresses.empty();
+        linkUp = !gone && adapter->linkUp;
+        linkUpCount = gone ? listener.linkUpCount : adapter->linkUpCount;
+    }
+    const auto &name = listener.ifName;
+    auto window = std::chrono::seconds(m_Options.listenSeconds);
+    // The socket stays bound to the removed link, a replugged adapter is a new entry with a capture of its own
+    if (gone) {
+        if (!listener.quiet)
+            log("Adapter removed: ", name, ", closing the listen window");
+        listener.stopped = true;
+        return true;
+    }
+    if (cameraFound && m_Options.stopOnCamera) {
+        if (!listener.quiet)
+            log("Camera confirmed on adapter: ", name, ", closing the listen window early");
+        listener.stopped = true;
+        return true;
+    }
+    if (linkUpCount != listener.linkUpCount) {
+        // The carrier came back, whatever is on the other end may only be booting now
+        listener.linkUpCount = linkUpCount;
+        listener.started = now;
+        listener.deadline = now + window;
+        if (!listener.quiet)
+            log("Link came up on adapter: ", name, ", listening for another ", m_Options.listenSeconds, " s");
+    } else if (!linkUp) {
+        // Do not let the window run out while the link is still negotiating
+        auto limit = listener.started + std::chrono::seconds(m_Options.maxListenSeconds);
+        auto extended = std::min(now + window, limit);
+        if (extended > listener.deadline) {
+            listener.deadline = extended;
+            if (!listener.quiet && extended == limit)
+                log("Link still down on adapter: ", name, ", listen window extended to its ", m_Options.maxListenSeconds,
+                    " s limit");
+        }
+    }
+    return now >= listener.deadline;
+}
+
+void AutoConnectLinux::logCaptureSummary(Listener &listener) {
+    {
+        std::scoped_lock<std::mutex> lock(m_AdaptersMutex);
+        if (auto *adapter = m_Adapters.get(listener.adapter))
+            adapter->listening = false;
+    }
+    recordStatistics(listener);
+    const auto &capture = listener.capture;
+    if (capture.syscalls() == 0) {
+        log("Stopped listening on adapter: ", listener.ifName, ". ", capture.frames(), " frames captured");
+    } else {
+        std::ostringstream perSyscall;
+        perSyscall.precision(2);
+        perSyscall << std::fixed << static_cast<double>(capture.frames()) / static_cast<double>(capture.syscalls());
+        log("Stopped listening on adapter: ", listener.ifName, ". ", capture.frames(), " frames in ",
+            capture.syscalls(), " syscalls (", perSyscall.str(), " frames per syscall)");
+    }
+    publishStatistics(listener);
+}
+
+AutoConnect::PacketCapture::Statistics AutoConnectLinux::recordStatistics(Listener &listener) {
+    auto statistics = listener.capture.statistics();
+    std::scoped_lock<std::mutex> lock(m_AdaptersMutex);
+    auto *adapter = m_Adapters.get(listener.adapter);
+    if (adapter == nullptr)
+        return statistics;
+    auto &total = adapter->statistics;
+    total.kernelPackets += statistics.kernelPackets;
+    total.kernelDrops += statistics.kernelDrops;
+    total.frames += statistics.frames;
+    total.bytes += statistics.bytes;
+    total.classified += listener.classified;
+    return statistics;
+}
+
+void AutoConnectLinux::publishStatistics(const Listener &listener) {
+    Adapter::Statistics statistics;
+    nlohmann::json linkLocal;
+    {
+        std::scoped_lock<std::mutex> lock(m_AdaptersMutex);
+        auto *adapter = m_Adapters.get(listener.adapter);
+        if (adapter == nullptr)
+            return;
+        statistics = adapter->statistics;
+        linkLocal = adapter->linkLocalToJson();
+    }
+    log("Capture statistics for adapter: ", listener.ifName, ". Kernel: ", statistics.kernelPackets, " packets, ",
+        statistics.kernelDrops, " dropped. Read: ", statistics.frames, " frames, ", statistics.bytes, " bytes, ",
+        statistics.classified, " classified");
+    std::scoped_lock<std::mutex> lock(m_logQueueMutex);
+    out["Statistics"][listener.ifName] = statistics.toJson();
+    out["LinkLocal"][listener.ifName] = linkLocal;
+    // A camera is usually confirmed while its listener is still running, bring its Result entry up to date
+    if (out.contains("Result")) {
+        for (auto &result: out["Result"]) {
+            if (result["Name"] == listener.ifName)
+                result["Statistics"] = statistics.toJson();
+        }
+    }
+}
 
-    int sd = 0;
-    if ((sd = socket(PF_PACKET, SOCK_RAW, htons(ETH_P_IP))) < 0) {
-        app->log("socket() Failed to get socket descriptor for using ioctl() ", adapter->ifName, " : ",
-                 strerror(errno));
+bool AutoConnectLinux::startListening(Listener &listener, uint16_t fanoutGroup) {
+    {
+        std::scoped_lock<std::mutex> lock(m_AdaptersMutex);
+        auto *adapter = m_Adapters.get(listener.adapter);
+        if (adapter == nullptr)
+            return false;
+        listener.ifIndex = adapter->ifIndex;
+        listener.ifName = adapter->ifName;
     }
+    log("Configuring adapter: ", listener.ifName);
 
-    struct sockaddr_ll addr{};
-    // Bind socket to interface
-    memset(&addr, 0x00, sizeof(addr));
-    addr.sll_family = AF_PACKET;
-    addr.sll_protocol = htons(ETH_P_ALL);
-    addr.sll_ifindex = (int) adapter->ifIndex;
-    if (bind(sd, (struct sockaddr *) &addr, sizeof(addr)) == -1) {
-        app->log("Error in bind: ", adapter->ifName, " : ", strerror(errno));
+    AutoConnect::PacketCapture::Config config;
+    config.mode = m_Options.captureMode;
+    config.batchSize = m_Options.batchSize;
+    config.xdpNative = m_Options.xdpNative;
+    config.fanoutGroup = fanoutGroup;
+    config.fanoutMode = m_Options.fanoutMode;
+    config.busyPollUsecs = m_Options.busyPollUsecs;
+    if (!listener.capture.open(listener.ifIndex, config)) {
+        log("Failed to open capture socket on ", listener.ifName, " : ", listener.capture.errorMessage());
+        std::scoped_lock<std::mutex> lock(m_AdaptersMutex);
+        if (auto *adapter = m_Adapters.get(listener.adapter))
+            adapter->listening = false;
+        return false;
+    }
+    auto mode = listener.capture.mode();
+    if (m_Options.captureMode == AutoConnect::PacketCapture::Mode::Xdp && mode != AutoConnect::PacketCapture::Mode::Xdp) {
+        log("AF_XDP capture not available on ", listener.ifName, " (", listener.capture.errorMessage(),
+            "). Using a packet socket instead");
+    } else if (mode == AutoConnect::PacketCapture::Mode::Batch &&
+               m_Options.captureMode != AutoConnect::PacketCapture::Mode::Batch && !listener.capture.isBusyPolling()) {
+        log("Packet ring not available on ", listener.ifName, " (", listener.capture.errorMessage(),
+            "). Receiving frames in batches instead");
+    }
+    if (m_Options.busyPollUsecs != 0 && !listener.capture.isBusyPolling()) {
+        log("Busy polling not available on ", listener.ifName, " (", listener.capture.errorMessage(),
+            "). Sleeping until frames arrive instead");
     }
+    if (mode != AutoConnect::PacketCapture::Mode::Xdp && !listener.capture.isFiltered()) {
+        log("Could not attach discovery filter on ", listener.ifName, " (", listener.capture.errorMessage(),
+            "). Receiving all frames");
+    }
+
     // set the network card in promiscuos mode//
     // An ioctl() request has encoded in it whether the argument is an in parameter or out parameter
     // SIOCGIFFLAGS	0x8913		// get flags			//
     // SIOCSIFFLAGS	0x8914		// set flags			//
-    struct ifreq ethreq{};
-    strncpy(ethreq.ifr_name, adapter->ifName.c_str(), IF_NAMESIZE);
-    if (ioctl(sd, SIOCGIFFLAGS, &ethreq) == -1) {
-        app->log("Error in ioctl get flags: ", adapter->ifName, " : ", strerror(errno));
-    }
-    ethreq.ifr_flags |= IFF_PROMISC;
-
-    if (ioctl(sd, SIOCSIFFLAGS, &ethreq) == -1) {
-        app->log("Error in ioctl set flags: ", adapter->ifName, " : ", strerror(errno));
-    }
-
-    int saddr_size, data_size;
-    struct sockaddr saddr{};
-    auto *buffer = (unsigned char *) malloc(IP_MAXPACKET + 1);
-    auto startListenTime = std::chrono::steady_clock::now();
-    float timeOut = 15.0f;
-    app->log("Performing MultiSense camera search on adapter: ", adapter->ifName);
-    while (app->m_ListenOnAdapter) {
-        // Timeout handler
-        // Will timeout MAX_CONNECTION_ATTEMPTS times until retrying on new adapter
-        auto timeSpan = std::chrono::duration_cast<std::chrono::duration<float>>(
-                std::chrono::steady_clock::now() - startListenTime);
-        if (timeSpan.count() > timeOut)         // x Seconds, then break loop
-            break;
+    // Use a plain inet socket since AF_XDP sockets do not pass interface ioctls on
+    int sd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sd < 0) {
+        log("Failed to open socket for promiscuous mode on ", listener.ifName, " : ", strerror(errno));
+    } else {
+        struct ifreq ethreq{};
+        strncpy(ethreq.ifr_name, listener.ifName.c_str(), IF_NAMESIZE);
+        // Without the current flags the set would write IFF_PROMISC alone and take the interface down
+        if (ioctl(sd, SIOCGIFFLAGS, &ethreq) == -1) {
+            log("Error in ioctl get flags: ", listener.ifName, " : ", strerror(errno));
+        } else {
+            ethreq.ifr_flags |= IFF_PROMISC;
 
-        saddr_size = sizeof(saddr);
-        //Receive a packet
-        data_size = (int) recvfrom(sd, buffer, IP_MAXPACKET, MSG_DONTWAIT, &saddr,
-                                   (socklen_t *) &saddr_size);
-        if (data_size < 0) {
-            continue;
+            if (ioctl(sd, SIOCSIFFLAGS, &ethreq) == -1) {
+                log("Error in ioctl set flags: ", listener.ifName, " : ", strerror(errno));
+            }
         }
+        close(sd);
+    }
 
-        //Now process the packet
-        auto *iph = (struct iphdr *) (buffer + sizeof(struct ethhdr));
-        struct in_addr ip_addr{};
-        std::string address;
-        if (iph->protocol == IPPROTO_IGMP) //Check the Protocol and do accordingly...
-        {
-            ip_addr.s_addr = iph->saddr;
-            address = inet_ntoa(ip_addr);
-            // If not already in vector
-            std::scoped_lock<std::mutex> lock(app->m_AdaptersMutex);
-            // Check if we havent added this ip or searched it before
-            if (std::find(adapter->IPAddresses.begin(), adapter->IPAddresses.end(), address) ==
-                adapter->IPAddresses.end() &&
-                std::find(adapter->searchedIPs.begin(), adapter->searchedIPs.end(), address) ==
-                adapter->searchedIPs.end()
-                    ) {
-                app->log("Got address ", address.c_str(), " On adapter: ", adapter->ifName.c_str());
-                adapter->IPAddresses.emplace_back(address);
-            }
+    listener.started = std::chrono::steady_clock::now();
+    listener.deadline = listener.started + std::chrono::seconds(m_Options.listenSeconds);
+    {
+        std::scoped_lock<std::mutex> lock(m_AdaptersMutex);
+        auto *adapter = m_Adapters.get(listener.adapter);
+        if (adapter == nullptr)
+            return false;
+        listener.linkUpCount = adapter->linkUpCount;
+        adapter->listening = true;
+    }
+    log("Performing MultiSense camera search on adapter: ", listener.ifName, " using ",
+        AutoConnect::PacketCapture::modeName(listener.capture.mode()), " capture");
+    return true;
+}
+
+void AutoConnectLinux::onFrame(void *ctx, const AutoConnect::PacketCapture::Frame &frame) {
+    auto *listener = static_cast<Listener *>(ctx);
+    auto *app = listener->app;
+    AutoConnect::Candidate candidate;
+    if (!AutoConnect::FrameClassifier::classify(frame.data, frame.length, candidate, frame.vlan))
+        return;
+    candidate.classifiedNs = AutoConnect::PacketCapture::realtimeNs();
+    candidate.receivedNs = frame.timestampNs != 0 ? frame.timestampNs : candidate.classifiedNs;
+    // Any host answers ARP, a reply is only worth something if it answers our own sweep
+    uint32_t replyAddress = 0;
+    if (candidate.evidence == AutoConnect::Evidence::ArpReply &&
+        (!listener->sweep || !listener->sweep->isReply(frame.data, frame.length, replyAddress)))
+        return;
+
+    listener->classified++;
+    // Repeated evidence from the same sender is dropped here without taking any lock. IPv6 senders are told apart by
+    // the low four bytes of their MAC, a collision only hides a second host on the same link
+    bool ipv6 = AutoConnect::FrameClassifier::isIpv6(candidate.evidence);
+    uint32_t key = candidate.address;
+    if (ipv6)
+        memcpy(&key, candidate.mac + 2, sizeof(key));
+    if (key != 0 && !listener->seen[static_cast<size_t>(candidate.evidence)].insert(key))
+        return;
+    std::scoped_lock<std::mutex> lock(app->m_AdaptersMutex);
+    auto *adapter = app->m_Adapters.get(listener->adapter);
+    if (adapter == nullptr)
+        return;
+    // LibMultiSense only connects over IPv4, so IPv6 hosts are reported and used to rank IPv4 candidates
+    if (ipv6) {
+        if (adapter->addLinkLocal(candidate)) {
+            char address[INET6_ADDRSTRLEN];
+            inet_ntop(AF_INET6, candidate.address6, address, sizeof(address));
+            app->log("Got link-local host ", address, " On adapter: ", adapter->ifName, vlanToString(candidate),
+                     " from ", AutoConnect::FrameClassifier::name(candidate.evidence), ", MAC ",
+                     macToString(candidate.mac));
         }
+        return;
+    }
+    // Check if we havent added this ip or searched it before
+    if (adapter->addCandidate(candidate)) {
+        app->log("Got address ", AutoConnect::AddressSet::toString(candidate.address), " On adapter: ",
+                 adapter->ifName, vlanToString(candidate), " from ",
+                 AutoConnect::FrameClassifier::name(candidate.evidence), " (confidence ", candidate.confidence, ")");
     }
-    free(buffer);
+}
+
+void AutoConnectLinux::replayCapture(void *ctx) {
+    auto *app = static_cast<AutoConnectLinux *>(ctx);
+    const auto &options = app->m_Options;
+
+    AutoConnect::PcapReader reader;
+    if (!reader.open(options.replayFile)) {
+        app->log("Failed to open capture file: ", reader.errorMessage());
+        app->m_IsRunning = false;
+        return;
+    }
+    // Load the whole file first so the measured time only covers parsing
+    struct ReplayFrame {
+        size_t offset;
+        uint32_t length;
+        std::chrono::nanoseconds timestamp;
+    };
+    std::vector<uint8_t> data;
+    std::vector<ReplayFrame> frames;
+    AutoConnect::PcapReader::Packet packet;
+    while (reader.next(packet)) {
+        frames.push_back({data.size(), packet.length, packet.timestamp});
+        data.insert(data.end(), packet.data, packet.data + packet.length);
+    }
+    if (!reader.errorMessage().empty())
+        app->log("Stopped reading ", options.replayFile, " early: ", reader.errorMessage());
+    app->log("Replaying ", frames.size(), " frames from ", options.replayFile,
+             options.replayRealtime ? " at recorded speed" : " at full speed");
+
+    // Frames are attributed to a stand-in adapter so the live frame handler can be used as is
+    Listener listener;
+    listener.app = app;
+    listener.ifName = "replay";
+    {
+        std::scoped_lock<std::mutex> lock(app->m_AdaptersMutex);
+        listener.adapter = app->m_Adapters.insert(0, Adapter(listener.ifName.c_str(), 0));
+    }
+
+    uint64_t replayed = 0;
+    uint64_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &frame: frames) {
+        if (!app->m_ListenOnAdapter)
+            break;
+        if (options.replayRealtime)
+            std::this_thread::sleep_until(start + (frame.timestamp - frames.front().timestamp));
+        // Capture tools put the tags the kernel removed back into the recorded frame. The recorded time says
+        // nothing about this run, so the frame counts as received when it is classified
+        onFrame(&listener, {data.data() + frame.offset, frame.length, {}, 0});
+        replayed++;
+        bytes += frame.length;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(
+            std::chrono::steady_clock::now() - start).count();
+
+    std::ostringstream rate;
+    rate.precision(0);
+    rate << std::fixed << (elapsed > 0 ? static_cast<double>(replayed) / elapsed : 0.0);
+    app->log("Replayed ", replayed, " frames (", bytes, " bytes, ", listener.classified, " classified) in ",
+             static_cast<uint64_t>(elapsed * 1e6), " us, ", rate.str(), " frames per second");
+    {
+        std::scoped_lock<std::mutex> lock(app->m_AdaptersMutex);
+        app->log("Found ", app->m_Adapters.get(listener.adapter)->candidates.size(), " candidate address(es) in ",
+                 options.replayFile);
+    }
+    app->m_IsRunning = false;
 }
 
 void AutoConnectLinux::setHostAddress(const std::string &adapterName, const std::string &hostAddress) {
@@ -408,18 +1391,22 @@ void AutoConnectLinux::setMTU(const std::string &adapterName, int mtu) {
     }
 }
 
-void AutoConnectLinux::checkForCamera(void *ctx, Adapter *adapter) {
+void AutoConnectLinux::checkForCamera(void *ctx, AdapterHandle handle) {
+    AutoConnect::Candidate candidate;
+    uint32_t ip = 0;
+    uint32_t ifIndex = 0;
     std::string address;
     std::string adapterName;
     auto *app = static_cast<AutoConnectLinux *>(ctx);
     {
         std::scoped_lock<std::mutex> lock(app->m_AdaptersMutex);
-        if (!app->m_IsRunning || !app->m_ListenOnAdapter || !app->m_ScanAdapters)
+        auto *adapter = app->m_Adapters.get(handle);
+        if (adapter == nullptr || !app->m_IsRunning || !app->m_ListenOnAdapter || !app->m_ScanAdapters)
             return;
 
         bool searchedAll = true;
-        for (const auto &item: adapter->IPAddresses) {
-            if (!adapter->isSearched(item)) {
+        for (const auto &item: adapter->candidates) {
+            if (!adapter->isSearched(item.address)) {
                 searchedAll = false;
             }
         }
@@ -427,44 +1414,146 @@ void AutoConnectLinux::checkForCamera(void *ctx, Adapter *adapter) {
             adapter->checkingForCamera = false;
             return;
         }
-        address = adapter->IPAddresses.front();
+        // Other candidates stay queued, a camera found later may teach us their vendor prefix
+        if (app->m_Options.ouiOnly && !adapter->hasVendorCandidate(app->m_VendorOuis)) {
+            adapter->checkingForCamera = false;
+            return;
+        }
+        candidate = adapter->takeBestCandidate(app->m_VendorOuis);
+        ip = candidate.address;
+        address = AutoConnect::AddressSet::toString(ip);
         adapterName = adapter->ifName;
-        adapter->IPAddresses.erase(adapter->IPAddresses.begin());
-        app->log("Checking for camera at ", address.c_str(), " on: ", adapter->ifName.c_str());
+        ifIndex = adapter->ifIndex;
+        app->log("Checking for camera at ", address.c_str(), " on: ", adapter->ifName.c_str(),
+                 vlanToString(candidate), " (", AutoConnect::FrameClassifier::name(candidate.evidence),
+                 ", confidence ", candidate.confidence, ", MAC ", macToString(candidate.mac), ")");
 
     }
+    ProbeTiming timing;
+    timing.probeNs = AutoConnect::PacketCapture::realtimeNs();
+    // A tagged camera is reached through a VLAN sub-interface, nested for double tagged frames
+    std::vector<AutoConnect::VlanInterface::Link> vlanLinks;
+    if (candidate.vlanId != 0) {
+        AutoConnect::VlanInterface::Link link;
+        std::string error;
+        bool acquired = AutoConnect::VlanInterface::acquire(ifIndex, adapterName, candidate.vlanId,
+                                                            candidate.vlanProtocol, link, error);
+        if (acquired)
+            vlanLinks.emplace_back(link);
+        if (acquired && candidate.innerVlanId != 0) {
+            acquired = AutoConnect::VlanInterface::acquire(link.ifIndex, link.ifName, candidate.innerVlanId,
+                                                           ETH_P_8021Q, link, error);
+            if (acquired)
+                vlanLinks.emplace_back(link);
+        }
+        if (!acquired) {
+            app->log("Cannot set up a VLAN interface for ", address, vlanToString(candidate), " on: ", adapterName,
+                     " : ", error);
+            app->removeVlanLinks(vlanLinks);
+            std::scoped_lock<std::mutex> lock(app->m_AdaptersMutex);
+            if (auto *adapter = app->m_Adapters.get(handle)) {
+                adapter->searchedIPs.insert(ip);
+                adapter->checkingForCamera = false;
+            }
+            return;
+        }
+        app->log(link.created ? "Created VLAN interface " : "Using VLAN interface ", link.ifName, " for ", address);
+    }
+    std::string parentName = adapterName;
+    if (!vlanLinks.empty())
+        adapterName = vlanLinks.back().ifName;
     // Set the host ip address to the same subnet but with *.2 at the end.
     std::string hostAddress = address;
     std::string last_element(hostAddress.substr(hostAddress.rfind(".")));
     auto ptr = hostAddress.rfind('.');
     hostAddress.replace(ptr, last_element.length(), ".2");
+    uint32_t hostIp = 0;
+    inet_pton(AF_INET, hostAddress.c_str(), &hostIp);
+    {
+        std::scoped_lock<std::mutex> lock(app->m_AdaptersMutex);
+        if (auto *adapter = app->m_Adapters.get(handle))
+            adapter->hostAddress = hostIp;
+    }
+    timing.addressNs = AutoConnect::PacketCapture::realtimeNs();
+    // Subscribed before the change so its notification cannot be missed
+    AutoConnect::Netlink netlink;
+    bool watching = netlink.open(RTMGRP_IPV4_IFADDR);
     app->setHostAddress(adapterName, hostAddress);
-    // Add a delay to let changes propagate through system
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    // Probe as soon as the kernel reports the address with its final prefix. Sleep out the timeout if it does not
+    uint32_t probeIndex = vlanLinks.empty() ? ifIndex : vlanLinks.back().ifIndex;
+    if (!watching || !waitForAddress(netlink, probeIndex, hostIp, 24)) {
+        app->log("No address notification for ", hostAddress, " on: ", adapterName, ", waiting ",
+                 ADDRESS_SETTLE_TIMEOUT_MS, " ms");
+        auto left = std::chrono::milliseconds(ADDRESS_SETTLE_TIMEOUT_MS) -
+                    std::chrono::nanoseconds(AutoConnect::PacketCapture::realtimeNs() - timing.addressNs);
+        if (left.count() > 0)
+            std::this_thread::sleep_for(left);
+    }
+    netlink.close();
+    timing.connectNs = AutoConnect::PacketCapture::realtimeNs();
     auto *channelPtr = crl::multisense::Channel::Create(address, adapterName);
+    timing.connectedNs = AutoConnect::PacketCapture::realtimeNs();
     {
         std::scoped_lock<std::mutex> lock(app->m_AdaptersMutex);
+        auto *adapter = app->m_Adapters.get(handle);
+        if (adapter == nullptr) {
+            // The link went away while we probed, a replugged adapter is searched again from scratch
+            app->log("Adapter removed while checking for camera at ", address, " on: ", adapterName);
+            if (channelPtr != nullptr)
+                crl::multisense::Channel::Destroy(channelPtr);
+            return;
+        }
         if (channelPtr != nullptr) {
             app->log("Success. Found a MultiSense device at: ", address.c_str(), " on: ", adapterName.c_str());
             crl::multisense::system::DeviceInfo info;
             channelPtr->getDeviceInfo(info);
             crl::multisense::Channel::Destroy(channelPtr);
+            // A VLAN cannot have a larger MTU than the interface below it, so raise them from the bottom up
+            if (!vlanLinks.empty())
+                app->setMTU(parentName, 7200);
+            for (size_t i = 0; i + 1 < vlanLinks.size(); ++i)
+                app->setMTU(vlanLinks[i].ifName, 7200);
             app->setMTU(adapterName, 7200);
 
             adapter->cameraNameList.emplace_back(info.name);
             adapter->cameraIPAddresses.emplace_back(address);
+            adapter->cameraInterfaces.emplace_back(adapterName);
+            adapter->cameraVlans.emplace_back(candidate.vlanId);
+            adapter->cameraTimings.emplace_back(timing.toJson(candidate));
+            app->log("Timing for ", address, ": ", timing.summary(candidate));
+            // Cameras of the same make found later are probed first
+            uint32_t oui = AutoConnect::FrameClassifier::oui(candidate.mac);
+            if (oui != 0 && std::find(app->m_VendorOuis.begin(), app->m_VendorOuis.end(), oui) ==
+                            app->m_VendorOuis.end()) {
+                app->m_VendorOuis.emplace_back(oui);
+                app->log("Learned camera vendor MAC prefix ", macToString(candidate.mac).substr(0, 8));
+            }
             {
                 std::scoped_lock<std::mutex> lock2(app->m_logQueueMutex);
                 app->out["Result"].emplace_back(adapter->sendAdapterResult());
             }
         } else {
             app->log("No camera at ", address);
+            app->removeVlanLinks(vlanLinks);
         }
-        adapter->searchedIPs.emplace_back(address);
+        adapter->searchedIPs.insert(ip);
         adapter->checkingForCamera = false;
     }
 }
 
+void AutoConnectLinux::removeVlanLinks(const std::vector<AutoConnect::VlanInterface::Link> &links) {
+    // Innermost first, deleting an outer VLAN would silently take the inner one with it
+    for (auto it = links.rbegin(); it != links.rend(); ++it) {
+        std::string error;
+        if (!it->created)
+            continue;
+        if (AutoConnect::VlanInterface::remove(*it, error))
+            log("Removed VLAN interface ", it->ifName);
+        else
+            log("Failed to remove VLAN interface ", it->ifName, " : ", error);
+    }
+}
+
 void AutoConnectLinux::cleanUp() {
     m_IsRunning = false;
     m_ListenOnAdapter = false;
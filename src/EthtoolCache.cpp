@@ -0,0 +1,108 @@
+/**
+ * @file: AutoConnect/src/EthtoolCache.cpp
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#include <climits>
+#include <cstring>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <linux/ethtool.h>
+#include <linux/sockios.h>
+
+#include "AutoConnect/EthtoolCache.h"
+
+namespace AutoConnect {
+
+    EthtoolCache::~EthtoolCache() {
+        if (m_Fd != -1)
+            ::close(m_Fd);
+    }
+
+    const EthtoolCache::Info &EthtoolCache::lookup(uint32_t ifIndex, const std::string &ifName, bool linkUp) {
+        auto now = std::chrono::steady_clock::now();
+        auto it = m_Entries.find(ifIndex);
+        if (it != m_Entries.end() && it->second.ifName == ifName && it->second.linkUp == linkUp &&
+            now - it->second.updated < std::chrono::seconds(ETHTOOL_CACHE_TTL_SECONDS))
+            return it->second.info;
+        auto &entry = m_Entries[ifIndex];
+        entry.ifName = ifName;
+        entry.linkUp = linkUp;
+        entry.updated = now;
+        entry.info = Info();
+        query(ifName, entry.info);
+        return entry.info;
+    }
+
+    void EthtoolCache::forget(uint32_t ifIndex) {
+        m_Entries.erase(ifIndex);
+    }
+
+    void EthtoolCache::query(const std::string &ifName, Info &info) {
+        if (m_Fd == -1)
+            m_Fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_IP);
+        if (m_Fd == -1)
+            return;
+        // The link mode bitmaps follow the request header in memory, three of them with up to SCHAR_MAX words each
+        alignas(struct ethtool_link_settings) uint8_t buffer[sizeof(struct ethtool_link_settings) +
+                                                             3 * SCHAR_MAX * sizeof(uint32_t)]{};
+        auto &request = *reinterpret_cast<struct ethtool_link_settings *>(buffer);
+
+        struct ifreq ifr{};
+        std::strncpy(ifr.ifr_name, ifName.c_str(), IF_NAMESIZE - 1);
+        ifr.ifr_data = reinterpret_cast<char *>(buffer);
+
+        // Handshake: the first request has no room for the bitmaps and the kernel answers with their negated size
+        request.cmd = ETHTOOL_GLINKSETTINGS;
+        m_Requests++;
+        if (ioctl(m_Fd, SIOCETHTOOL, &ifr) == -1 || request.link_mode_masks_nwords >= 0 ||
+            request.cmd != ETHTOOL_GLINKSETTINGS)
+            return;
+        int8_t words = static_cast<int8_t>(-request.link_mode_masks_nwords);
+        request.link_mode_masks_nwords = words;
+        m_Requests++;
+        if (ioctl(m_Fd, SIOCETHTOOL, &ifr) == -1 || request.link_mode_masks_nwords != words)
+            return;
+
+        info.ethernet = true;
+        info.speedMbps = request.speed == (uint32_t) SPEED_UNKNOWN ? 0 : request.speed;
+        info.duplex = request.duplex;
+        info.port = request.port;
+        // Supported modes come first, then advertised and link partner modes
+        info.supportedModes.assign(request.link_mode_masks, request.link_mode_masks + words);
+    }
+}
@@ -0,0 +1,269 @@
+/**
+ * @file: AutoConnect/src/FrameClassifier.cpp
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#include <cstring>
+#include <arpa/inet.h>
+#include <net/if_arp.h>
+#include <linux/if_ether.h>
+#include <netinet/ip.h>
+#include <netinet/ip6.h>
+#include <netinet/icmp6.h>
+#include <netinet/udp.h>
+
+#include "AutoConnect/FrameClassifier.h"
+
+#define IP_FRAGMENT_OFFSET_MASK 0x1fff
+#define VLAN_HLEN 4
+#define VLAN_VID_MASK 0x0fff
+// ICMPv6 types of MLD reports, MLD_LISTENER_REPORT is version 1
+#define MLDV2_LISTENER_REPORT 143
+
+namespace AutoConnect {
+
+    struct __attribute__((packed)) ArpPayload {
+        struct arphdr header;
+        uint8_t senderHardware[ETH_ALEN];
+        uint32_t senderAddress;
+        uint8_t targetHardware[ETH_ALEN];
+        uint32_t targetAddress;
+    };
+
+    static bool classifyArp(const uint8_t *data, uint32_t length, Candidate &candidate) {
+        if (length < sizeof(ArpPayload))
+            return false;
+        const auto *arp = reinterpret_cast<const ArpPayload *>(data);
+        if (arp->header.ar_hrd != htons(ARPHRD_ETHER) || arp->header.ar_pro != htons(ETH_P_IP) ||
+            arp->header.ar_hln != ETH_ALEN || arp->header.ar_pln != 4)
+            return false;
+        // Probes from hosts that have no address yet carry 0.0.0.0
+        if (arp->senderAddress == 0)
+            return false;
+        memcpy(candidate.mac, arp->senderHardware, ETH_ALEN);
+        candidate.address = arp->senderAddress;
+        if (arp->senderAddress == arp->targetAddress)
+            candidate.evidence = Evidence::GratuitousArp;
+        else if (arp->header.ar_op == htons(ARPOP_REQUEST))
+            candidate.evidence = Evidence::ArpRequest;
+        else if (arp->header.ar_op == htons(ARPOP_REPLY))
+            candidate.evidence = Evidence::ArpReply;
+        else
+            return false;
+        return true;
+    }
+
+    static bool classifyIpv4(const uint8_t *data, uint32_t length, Candidate &candidate) {
+        if (length < sizeof(struct iphdr))
+            return false;
+        const auto *iph = reinterpret_cast<const struct iphdr *>(data);
+        uint32_t headerLength = iph->ihl * 4u;
+        if (iph->version != 4 || headerLength < sizeof(struct iphdr) || iph->saddr == 0)
+            return false;
+        candidate.address = iph->saddr;
+        if (iph->protocol == IPPROTO_IGMP) {
+            candidate.evidence = Evidence::Igmp;
+            return true;
+        }
+        // Only the first fragment has the UDP header
+        if (iph->protocol == IPPROTO_UDP && !(ntohs(iph->frag_off) & IP_FRAGMENT_OFFSET_MASK) &&
+            length >= headerLength + sizeof(struct udphdr)) {
+            const auto *udp = reinterpret_cast<const struct udphdr *>(data + headerLength);
+            if (udp->source == htons(MULTISENSE_CONTROL_PORT)) {
+                candidate.evidence = Evidence::MultiSenseUdp;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool classifyIpv6(const uint8_t *data, uint32_t length, Candidate &candidate) {
+        if (length < sizeof(struct ip6_hdr))
+            return false;
+        const auto *ip6 = reinterpret_cast<const struct ip6_hdr *>(data);
+        // Only link-local sources, fe80::/10, identify a host on this link
+        if ((ip6->ip6_vfc >> 4) != 6 || ip6->ip6_src.s6_addr[0] != 0xfe || (ip6->ip6_src.s6_addr[1] & 0xc0) != 0x80)
+            return false;
+        uint32_t offset = sizeof(struct ip6_hdr);
+        uint8_t next = ip6->ip6_nxt;
+        // MLD reports carry a hop-by-hop header with the router alert option
+        if (next == IPPROTO_HOPOPTS) {
+            if (length < offset + sizeof(struct ip6_hbh))
+                return false;
+            const auto *hopByHop = reinterpret_cast<const struct ip6_hbh *>(data + offset);
+            next = hopByHop->ip6h_nxt;
+            offset += (hopByHop->ip6h_len + 1u) * 8;
+        }
+        if (next != IPPROTO_ICMPV6 || length < offset + sizeof(struct icmp6_hdr))
+            return false;
+        const auto *icmp = reinterpret_cast<const struct icmp6_hdr *>(data + offset);
+        if (icmp->icmp6_type == MLD_LISTENER_REPORT || icmp->icmp6_type == MLDV2_LISTENER_REPORT)
+            candidate.evidence = Evidence::Mld;
+        else if (icmp->icmp6_type == ND_NEIGHBOR_ADVERT)
+            candidate.evidence = Evidence::NeighborAdvertisement;
+        else
+            return false;
+        memcpy(candidate.address6, &ip6->ip6_src, sizeof(candidate.address6));
+        return true;
+    }
+
+    static bool isVlanProtocol(uint16_t protocol) {
+        return protocol == ETH_P_8021Q || protocol == ETH_P_8021AD;
+    }
+
+    uint32_t FrameClassifier::payloadOffset(const uint8_t *data, uint32_t length, VlanTag tags[FRAME_MAX_VLAN_TAGS],
+                                            uint32_t &tagCount, uint16_t &protocol) {
+        tagCount = 0;
+        if (length < ETH_HLEN)
+            return 0;
+        // The EtherType of each tag sits right where the payload EtherType would be, 4 bytes further along
+        uint32_t offset = ETH_HLEN - 2;
+        protocol = (uint16_t) (data[offset] << 8 | data[offset + 1]);
+        while (isVlanProtocol(protocol)) {
+            if (tagCount == FRAME_MAX_VLAN_TAGS || length < offset + 2 + VLAN_HLEN)
+                return 0;
+            tags[tagCount].protocol = protocol;
+            tags[tagCount].tci = (uint16_t) (data[offset + 2] << 8 | data[offset + 3]);
+            ++tagCount;
+            offset += VLAN_HLEN;
+            protocol = (uint16_t) (data[offset] << 8 | data[offset + 1]);
+        }
+        return offset + 2;
+    }
+
+    bool FrameClassifier::classify(const uint8_t *data, uint32_t length, Candidate &candidate, VlanTag stripped) {
+        VlanTag tags[FRAME_MAX_VLAN_TAGS + 1];
+        uint32_t tagCount = 0;
+        if (stripped.protocol != 0)
+            tags[tagCount++] = stripped;
+        uint32_t inFrame = 0;
+        uint16_t protocol = 0;
+        uint32_t offset = payloadOffset(data, length, tags + tagCount, inFrame, protocol);
+        tagCount += inFrame;
+        if (offset == 0 || tagCount > FRAME_MAX_VLAN_TAGS)
+            return false;
+
+        const auto *eth = reinterpret_cast<const struct ethhdr *>(data);
+        memcpy(candidate.mac, eth->h_source, ETH_ALEN);
+        bool found = false;
+        if (protocol == ETH_P_ARP)
+            found = classifyArp(data + offset, length - offset, candidate);
+        else if (protocol == ETH_P_IP)
+            found = classifyIpv4(data + offset, length - offset, candidate);
+        else if (protocol == ETH_P_IPV6)
+            found = classifyIpv6(data + offset, length - offset, candidate);
+        if (!found)
+            return false;
+        candidate.confidence = confidence(candidate.evidence);
+        // Priority tagged frames carry VLAN 0 and belong to the untagged network
+        if (tagCount > 0 && (tags[0].tci & VLAN_VID_MASK) != 0) {
+            candidate.vlanId = tags[0].tci & VLAN_VID_MASK;
+            candidate.vlanProtocol = tags[0].protocol;
+            if (tagCount > 1)
+                candidate.innerVlanId = tags[1].tci & VLAN_VID_MASK;
+        }
+        return true;
+    }
+
+    uint32_t FrameClassifier::confidence(Evidence evidence) {
+        switch (evidence) {
+            case Evidence::MultiSenseUdp:
+                return 95;
+            case Evidence::ArpReply:
+                return 60;
+            case Evidence::Igmp:
+                return 50;
+            case Evidence::Mld:
+                return 45;
+            case Evidence::GratuitousArp:
+                return 40;
+            case Evidence::NeighborAdvertisement:
+                return 35;
+            case Evidence::ArpRequest:
+                return 30;
+            case Evidence::Neighbor:
+                return 20;
+            default:
+                return 0;
+        }
+    }
+
+    bool FrameClassifier::parseOui(const char *text, uint32_t &oui) {
+        oui = 0;
+        int digits = 0;
+        for (const char *c = text; *c != '\0'; ++c) {
+            if (*c == ':' || *c == '-') {
+                if (digits % 2 != 0)
+                    return false;
+                continue;
+            }
+            int value;
+            if (*c >= '0' && *c <= '9')
+                value = *c - '0';
+            else if (*c >= 'a' && *c <= 'f')
+                value = *c - 'a' + 10;
+            else if (*c >= 'A' && *c <= 'F')
+                value = *c - 'A' + 10;
+            else
+                return false;
+            if (++digits > 6)
+                return false;
+            oui = oui << 4 | (uint32_t) value;
+        }
+        return digits == 6;
+    }
+
+    const char *FrameClassifier::name(Evidence evidence) {
+        switch (evidence) {
+            case Evidence::Neighbor:
+                return "neighbor table";
+            case Evidence::ArpRequest:
+                return "ARP request";
+            case Evidence::GratuitousArp:
+                return "gratuitous ARP";
+            case Evidence::Igmp:
+                return "IGMP";
+            case Evidence::ArpReply:
+                return "ARP reply";
+            case Evidence::MultiSenseUdp:
+                return "MultiSense UDP";
+            case Evidence::Mld:
+                return "MLD";
+            case Evidence::NeighborAdvertisement:
+                return "neighbor advertisement";
+            default:
+                return "none";
+        }
+    }
+}
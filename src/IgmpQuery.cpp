@@ -0,0 +1,137 @@
+/**
+ * @file: AutoConnect/src/IgmpQuery.cpp
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <netinet/ip.h>
+
+#include "AutoConnect/IgmpQuery.h"
+
+#define IGMP_ALL_HOSTS "224.0.0.1"
+#define IGMP_MEMBERSHIP_QUERY 0x11
+
+namespace AutoConnect {
+
+    static uint16_t checksum(const uint8_t *data, size_t length) {
+        uint32_t sum = 0;
+        for (size_t i = 0; i + 1 < length; i += 2)
+            sum += (uint32_t) (data[i] << 8 | data[i + 1]);
+        if (length & 1)
+            sum += (uint32_t) data[length - 1] << 8;
+        while (sum >> 16)
+            sum = (sum & 0xffff) + (sum >> 16);
+        return htons((uint16_t) ~sum);
+    }
+
+    bool IgmpQuery::send(uint32_t ifIndex, const std::string &ifName, Version version, std::string &error) {
+        if (version == Version::Off)
+            return true;
+
+        int fd = socket(PF_PACKET, SOCK_RAW, 0);
+        if (fd < 0) {
+            error = std::string("socket: ") + strerror(errno);
+            return false;
+        }
+        struct ifreq ifr{};
+        strncpy(ifr.ifr_name, ifName.c_str(), IF_NAMESIZE - 1);
+        if (ioctl(fd, SIOCGIFHWADDR, &ifr) == -1 || ifr.ifr_hwaddr.sa_family != ARPHRD_ETHER) {
+            error = "cannot get Ethernet address";
+            ::close(fd);
+            return false;
+        }
+
+        // Ethernet, IPv4 with router alert option, then an IGMPv2 (8 bytes) or IGMPv3 (12 bytes) query
+        uint8_t frame[ETH_ZLEN] = {};
+        size_t igmpLength = version == Version::V3 ? 12 : 8;
+        auto *eth = reinterpret_cast<struct ethhdr *>(frame);
+        const uint8_t allHostsMac[ETH_ALEN] = {0x01, 0x00, 0x5e, 0x00, 0x00, 0x01};
+        memcpy(eth->h_dest, allHostsMac, ETH_ALEN);
+        memcpy(eth->h_source, ifr.ifr_hwaddr.sa_data, ETH_ALEN);
+        eth->h_proto = htons(ETH_P_IP);
+
+        uint8_t *ip = frame + ETH_HLEN;
+        auto *iph = reinterpret_cast<struct iphdr *>(ip);
+        iph->version = 4;
+        iph->ihl = 6;
+        iph->tot_len = htons((uint16_t) (24 + igmpLength));
+        iph->ttl = 1;
+        iph->protocol = IPPROTO_IGMP;
+        iph->saddr = 0;
+        iph->daddr = inet_addr(IGMP_ALL_HOSTS);
+        const uint8_t routerAlert[4] = {IPOPT_RA, 4, 0, 0};
+        memcpy(ip + 20, routerAlert, sizeof(routerAlert));
+        iph->check = checksum(ip, 24);
+
+        uint8_t *igmp = ip + 24;
+        igmp[0] = IGMP_MEMBERSHIP_QUERY;
+        // Max response time, the group address stays 0 for a general query. The v3 fields after it stay 0 as well:
+        // no suppression, default robustness and query interval, no sources
+        igmp[1] = IGMP_QUERY_RESPONSE_TIME_DS;
+        uint16_t igmpChecksum = checksum(igmp, igmpLength);
+        memcpy(igmp + 2, &igmpChecksum, sizeof(igmpChecksum));
+
+        struct sockaddr_ll addr{};
+        addr.sll_family = AF_PACKET;
+        addr.sll_protocol = htons(ETH_P_IP);
+        addr.sll_ifindex = (int) ifIndex;
+        addr.sll_halen = ETH_ALEN;
+        memcpy(addr.sll_addr, allHostsMac, ETH_ALEN);
+        bool sent = sendto(fd, frame, sizeof(frame), 0, (struct sockaddr *) &addr, sizeof(addr)) != -1;
+        if (!sent)
+            error = std::string("sendto: ") + strerror(errno);
+        ::close(fd);
+        return sent;
+    }
+
+    const char *IgmpQuery::versionName(Version version) {
+        switch (version) {
+            case Version::V2:
+                return "IGMPv2";
+            case Version::V3:
+                return "IGMPv3";
+            default:
+                return "off";
+        }
+    }
+}
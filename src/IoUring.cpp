@@ -0,0 +1,212 @@
+/**
+ * @file: AutoConnect/src/IoUring.cpp
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "AutoConnect/IoUring.h"
+
+namespace AutoConnect {
+
+    static int ioUringSetup(unsigned entries, struct io_uring_params *params) {
+        return (int) syscall(__NR_io_uring_setup, entries, params);
+    }
+
+    static int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+        return (int) syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0);
+    }
+
+    IoUring::~IoUring() {
+        if (m_Sqes != nullptr)
+            munmap(m_Sqes, m_SqesSize);
+        if (m_CqRing != nullptr && m_CqRing != m_SqRing)
+            munmap(m_CqRing, m_CqRingSize);
+        if (m_SqRing != nullptr)
+            munmap(m_SqRing, m_SqRingSize);
+        if (m_Fd >= 0)
+            close(m_Fd);
+    }
+
+    bool IoUring::init(unsigned entries) {
+        struct io_uring_params params{};
+        if ((m_Fd = ioUringSetup(entries, &params)) < 0) {
+            setError("io_uring_setup");
+            return false;
+        }
+
+        m_SqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_CqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        bool singleMap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMap)
+            m_SqRingSize = m_CqRingSize = std::max(m_SqRingSize, m_CqRingSize);
+
+        void *sq = mmap(nullptr, m_SqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_Fd,
+                        IORING_OFF_SQ_RING);
+        if (sq == MAP_FAILED) {
+            setError("mmap(IORING_OFF_SQ_RING)");
+            return false;
+        }
+        m_SqRing = sq;
+
+        if (singleMap) {
+            m_CqRing = m_SqRing;
+        } else {
+            void *cq = mmap(nullptr, m_CqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_Fd,
+                            IORING_OFF_CQ_RING);
+            if (cq == MAP_FAILED) {
+                setError("mmap(IORING_OFF_CQ_RING)");
+                return false;
+            }
+            m_CqRing = cq;
+        }
+
+        m_SqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+        void *sqes = mmap(nullptr, m_SqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_Fd,
+                          IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            setError("mmap(IORING_OFF_SQES)");
+            return false;
+        }
+        m_Sqes = static_cast<struct io_uring_sqe *>(sqes);
+
+        auto *sqBase = static_cast<uint8_t *>(m_SqRing);
+        m_SqHead = reinterpret_cast<unsigned *>(sqBase + params.sq_off.head);
+        m_SqTail = reinterpret_cast<unsigned *>(sqBase + params.sq_off.tail);
+        m_SqMask = reinterpret_cast<unsigned *>(sqBase + params.sq_off.ring_mask);
+        m_SqArray = reinterpret_cast<unsigned *>(sqBase + params.sq_off.array);
+        m_SqEntries = params.sq_entries;
+        m_SqeTail = *m_SqTail;
+
+        auto *cqBase = static_cast<uint8_t *>(m_CqRing);
+        m_CqHead = reinterpret_cast<unsigned *>(cqBase + params.cq_off.head);
+        m_CqTail = reinterpret_cast<unsigned *>(cqBase + params.cq_off.tail);
+        m_CqMask = reinterpret_cast<unsigned *>(cqBase + params.cq_off.ring_mask);
+        m_Cqes = reinterpret_cast<struct io_uring_cqe *>(cqBase + params.cq_off.cqes);
+        return true;
+    }
+
+    struct io_uring_sqe *IoUring::getSqe() {
+        if (m_Fd < 0)
+            return nullptr;
+        unsigned head = __atomic_load_n(m_SqHead, __ATOMIC_ACQUIRE);
+        if (m_SqeTail - head >= m_SqEntries) {
+            // Queue is full, hand what we have to the kernel to make room
+            if (submit(0) < 0)
+                return nullptr;
+            head = __atomic_load_n(m_SqHead, __ATOMIC_ACQUIRE);
+            if (m_SqeTail - head >= m_SqEntries)
+                return nullptr;
+        }
+        struct io_uring_sqe *sqe = &m_Sqes[m_SqeTail & *m_SqMask];
+        memset(sqe, 0, sizeof(*sqe));
+        ++m_SqeTail;
+        return sqe;
+    }
+
+    bool IoUring::pollAdd(int fd, uint32_t events, uint64_t userData) {
+        auto *sqe = getSqe();
+        if (sqe == nullptr)
+            return false;
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->fd = fd;
+        sqe->poll32_events = events;
+        sqe->user_data = userData;
+        return true;
+    }
+
+    bool IoUring::recvMsg(int fd, struct msghdr *message, uint64_t userData) {
+        auto *sqe = getSqe();
+        if (sqe == nullptr)
+            return false;
+        sqe->opcode = IORING_OP_RECVMSG;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uint64_t>(message);
+        sqe->len = 1;
+        sqe->user_data = userData;
+        return true;
+    }
+
+    bool IoUring::timeout(const struct __kernel_timespec *ts, uint64_t userData) {
+        auto *sqe = getSqe();
+        if (sqe == nullptr)
+            return false;
+        sqe->opcode = IORING_OP_TIMEOUT;
+        sqe->fd = -1;
+        sqe->addr = reinterpret_cast<uint64_t>(ts);
+        sqe->len = 1;
+        sqe->user_data = userData;
+        return true;
+    }
+
+    bool IoUring::cancel(uint64_t target, uint64_t userData) {
+        auto *sqe = getSqe();
+        if (sqe == nullptr)
+            return false;
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = target;
+        sqe->user_data = userData;
+        return true;
+    }
+
+    int IoUring::submit(unsigned waitNr) {
+        if (m_Fd < 0)
+            return -1;
+        // Publish the queued entries to the kernel
+        unsigned tail = *m_SqTail;
+        unsigned toSubmit = m_SqeTail - tail;
+        for (; tail != m_SqeTail; ++tail)
+            m_SqArray[tail & *m_SqMask] = tail & *m_SqMask;
+        __atomic_store_n(m_SqTail, tail, __ATOMIC_RELEASE);
+
+        int res = ioUringEnter(m_Fd, toSubmit, waitNr, waitNr > 0 ? IORING_ENTER_GETEVENTS : 0);
+        if (res < 0) {
+            if (errno == EINTR)
+                return 0;
+            setError("io_uring_enter");
+            return -1;
+        }
+        return res;
+    }
+
+    void IoUring::setError(const char *what) {
+        m_Error = std::string(what) + ": " + strerror(errno);
+    }
+}
@@ -0,0 +1,138 @@
+/**
+ * @file: AutoConnect/src/LinkClassifier.cpp
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <unistd.h>
+#include <net/if_arp.h>
+
+#include "AutoConnect/LinkClassifier.h"
+
+#define SYSFS_NET "/sys/class/net/"
+
+namespace AutoConnect {
+
+    LinkClassifier::Kind LinkClassifier::classify(uint32_t ifIndex, const std::string &ifName) {
+        auto it = m_Kinds.find(ifIndex);
+        if (it != m_Kinds.end() && it->second.first == ifName)
+            return it->second.second;
+        auto kind = read(ifName);
+        m_Kinds[ifIndex] = {ifName, kind};
+        return kind;
+    }
+
+    void LinkClassifier::forget(uint32_t ifIndex) {
+        m_Kinds.erase(ifIndex);
+    }
+
+    bool LinkClassifier::isSearchable(Kind kind, bool allowVirtual) {
+        switch (kind) {
+            case Kind::Unknown:
+            case Kind::Ethernet:
+            case Kind::UsbEthernet:
+                return true;
+            case Kind::Tun:
+            case Kind::Virtual:
+                return allowVirtual;
+            default:
+                return false;
+        }
+    }
+
+    const char *LinkClassifier::name(Kind kind) {
+        switch (kind) {
+            case Kind::Unknown:
+                return "unknown";
+            case Kind::Ethernet:
+                return "Ethernet";
+            case Kind::UsbEthernet:
+                return "USB Ethernet";
+            case Kind::Wireless:
+                return "wireless";
+            case Kind::Loopback:
+                return "loopback";
+            case Kind::Bridge:
+                return "bridge";
+            case Kind::Bond:
+                return "bond";
+            case Kind::Vlan:
+                return "VLAN";
+            case Kind::Tun:
+                return "tun/tap";
+            case Kind::Virtual:
+                return "virtual";
+            case Kind::Other:
+                return "other";
+        }
+        return "unknown";
+    }
+
+    LinkClassifier::Kind LinkClassifier::read(const std::string &ifName) {
+        std::string base = SYSFS_NET + ifName + "/";
+        int type = -1;
+        std::ifstream typeFile(base + "type");
+        if (!(typeFile >> type))
+            return Kind::Unknown;
+        auto exists = [&base](const char *entry) {
+            return access((base + entry).c_str(), F_OK) == 0;
+        };
+        if (type == ARPHRD_LOOPBACK)
+            return Kind::Loopback;
+        // The directories a driver adds tell the kind apart before the link type does, a tap device is ARPHRD_ETHER
+        if (exists("wireless") || exists("phy80211"))
+            return Kind::Wireless;
+        if (exists("bridge"))
+            return Kind::Bridge;
+        if (exists("bonding"))
+            return Kind::Bond;
+        if (exists("tun_flags"))
+            return Kind::Tun;
+        std::ifstream uevent(base + "uevent");
+        std::string line;
+        while (std::getline(uevent, line)) {
+            if (line == "DEVTYPE=vlan")
+                return Kind::Vlan;
+        }
+        if (type != ARPHRD_ETHER)
+            return Kind::Other;
+        // Physical adapters link to the bus device they sit on, software interfaces have no device
+        char device[PATH_MAX];
+        if (realpath((base + "device").c_str(), device) == nullptr)
+            return Kind::Virtual;
+        return std::string(device).find("/usb") != std::string::npos ? Kind::UsbEthernet : Kind::Ethernet;
+    }
+}
@@ -91,6 +91,35 @@ void usage(const char *programNameP) {
               << std::endl;
     std::cerr << "\t-c on/off    : Everthing logged to shared memory (IPC) is also logged to console (default false)"
               << std::endl;
+#ifndef WIN32
+    std::cerr << "\t-m mode      : Capture mode: auto, ring, batch, copy or xdp (default auto)" << std::endl;
+    std::cerr << "\t-n frames    : Frames received per syscall in batch mode (default " << CAPTURE_BATCH_SIZE << ")"
+              << std::endl;
+    std::cerr << "\t-e loop      : Event loop for adapter capture: epoll or uring (default epoll)" << std::endl;
+    std::cerr << "\t-x attach    : XDP attach mode for -m xdp: generic or native (default generic)" << std::endl;
+    std::cerr << "\t-f name=n    : Capture on adapter name with n threads in a PACKET_FANOUT group. May be repeated"
+              << std::endl;
+    std::cerr << "\t-F fanout    : How frames are spread over the fanout threads: hash or cpu (default hash)" << std::endl;
+    std::cerr << "\t-b usecs     : Busy poll the capture sockets for usecs before sleeping (default off)" << std::endl;
+    std::cerr << "\t-a rate      : Sweep likely camera subnets with ARP at rate requests per second (default off)"
+              << std::endl;
+    std::cerr << "\t-A subnet    : Extra a.b.c.d/n subnet to sweep with -a, /16 or smaller. May be repeated" << std::endl;
+    std::cerr << "\t-q version   : Send an IGMP general query when listening starts: off, v2 or v3 (default off)"
+              << std::endl;
+    std::cerr << "\t-o oui       : Probe candidates whose MAC starts with oui (aa:bb:cc) first. May be repeated"
+              << std::endl;
+    std::cerr << "\t-O           : Only probe candidates whose MAC matches a -o prefix or a camera found earlier"
+              << std::endl;
+    std::cerr << "\t               Needs at least one -o" << std::endl;
+    std::cerr << "\t-w seconds   : Listen window per adapter once its link is up (default " << LISTEN_TIMEOUT_SECONDS
+              << ")" << std::endl;
+    std::cerr << "\t-W seconds   : Longest listen window while the link is still down (default " << LISTEN_MAX_SECONDS
+              << ")" << std::endl;
+    std::cerr << "\t-k           : Keep listening on an adapter after a camera was found on it" << std::endl;
+    std::cerr << "\t-V           : Also search behind veth, tun and tap interfaces (skipped by default)" << std::endl;
+    std::cerr << "\t-r file      : Replay a pcap file through the discovery parser instead of capturing live" << std::endl;
+    std::cerr << "\t-p pace      : Replay pace for -r: recorded or max (default max)" << std::endl;
+#endif
     exit(1);
 }
 
@@ -98,22 +127,24 @@ int main(int argc, char **argv) {
 #ifdef WIN32
     SetConsoleCtrlHandler(signalHandler, TRUE);
 #else
-    if (getuid() != 0) {
-        std::cerr << "ERROR: This program must be run with root privileges" << std::endl;
-        exit(1);
-    }
-
     signal(SIGINT, signalHandler);
 #endif
 
     // Parse args
     bool runWithIpc = false;
     bool logToConsole = false;
+#ifndef WIN32
+    AutoConnect::DiscoveryOptions options;
+#endif
     int c;
     if (argc == 1)
         usage(*argv);
 
+#ifdef WIN32
     char * a = (char*) "i:c:";
+#else
+    char * a = (char*) "i:c:m:n:e:x:r:p:f:F:b:a:A:q:o:Ow:W:kV";
+#endif
     while (-1 != (c = getopt(argc, argv, a)))
         switch (c) {
             case 'i':
@@ -122,15 +153,149 @@ int main(int argc, char **argv) {
             case 'c':
                 logToConsole = std::string(optarg) == "on";
                 break;
+#ifndef WIN32
+            case 'm': {
+                std::string mode(optarg);
+                if (mode == "auto")
+                    options.captureMode = AutoConnect::PacketCapture::Mode::Auto;
+                else if (mode == "ring")
+                    options.captureMode = AutoConnect::PacketCapture::Mode::Ring;
+                else if (mode == "batch")
+                    options.captureMode = AutoConnect::PacketCapture::Mode::Batch;
+                else if (mode == "copy")
+                    options.captureMode = AutoConnect::PacketCapture::Mode::Copy;
+                else if (mode == "xdp")
+                    options.captureMode = AutoConnect::PacketCapture::Mode::Xdp;
+                else
+                    usage(*argv);
+                break;
+            }
+            case 'n':
+                options.batchSize = static_cast<uint32_t>(std::max(1, atoi(optarg)));
+                break;
+            case 'x': {
+                std::string attach(optarg);
+                if (attach == "generic")
+                    options.xdpNative = false;
+                else if (attach == "native")
+                    options.xdpNative = true;
+                else
+                    usage(*argv);
+                break;
+            }
+            case 'e': {
+                std::string loop(optarg);
+                if (loop == "epoll")
+                    options.eventLoop = AutoConnect::DiscoveryOptions::EventLoop::Epoll;
+                else if (loop == "uring")
+                    options.eventLoop = AutoConnect::DiscoveryOptions::EventLoop::IoUring;
+                else
+                    usage(*argv);
+                break;
+            }
+            case 'f': {
+                std::string arg(optarg);
+                auto separator = arg.find('=');
+                if (separator == std::string::npos || separator == 0)
+                    usage(*argv);
+                options.fanoutWorkers[arg.substr(0, separator)] =
+                        static_cast<uint32_t>(std::max(1, atoi(arg.c_str() + separator + 1)));
+                break;
+            }
+            case 'F': {
+                std::string fanout(optarg);
+                if (fanout == "hash")
+                    options.fanoutMode = AutoConnect::PacketCapture::Fanout::Hash;
+                else if (fanout == "cpu")
+                    options.fanoutMode = AutoConnect::PacketCapture::Fanout::Cpu;
+                else
+                    usage(*argv);
+                break;
+            }
+            case 'b':
+                options.busyPollUsecs = static_cast<uint32_t>(std::max(0, atoi(optarg)));
+                break;
+            case 'a':
+                options.arpSweepRate = static_cast<uint32_t>(std::max(0, atoi(optarg)));
+                break;
+            case 'A': {
+                AutoConnect::ArpSweep::Subnet subnet;
+                if (!AutoConnect::ArpSweep::parseSubnet(optarg, subnet))
+                    usage(*argv);
+                options.sweepSubnets.emplace_back(subnet);
+                break;
+            }
+            case 'q': {
+                std::string query(optarg);
+                if (query == "off")
+                    options.igmpQuery = AutoConnect::IgmpQuery::Version::Off;
+                else if (query == "v2")
+                    options.igmpQuery = AutoConnect::IgmpQuery::Version::V2;
+                else if (query == "v3")
+                    options.igmpQuery = AutoConnect::IgmpQuery::Version::V3;
+                else
+                    usage(*argv);
+                break;
+            }
+            case 'o': {
+                uint32_t oui;
+                if (!AutoConnect::FrameClassifier::parseOui(optarg, oui))
+                    usage(*argv);
+                options.vendorOuis.emplace_back(oui);
+                break;
+            }
+            case 'O':
+                options.ouiOnly = true;
+                break;
+            case 'w':
+                options.listenSeconds = static_cast<uint32_t>(std::max(1, atoi(optarg)));
+                break;
+            case 'W':
+                options.maxListenSeconds = static_cast<uint32_t>(std::max(1, atoi(optarg)));
+                break;
+            case 'k':
+                options.stopOnCamera = false;
+                break;
+            case 'V':
+                options.allowVirtual = true;
+                break;
+            case 'r':
+                options.replayFile = optarg;
+                break;
+            case 'p': {
+                std::string pace(optarg);
+                if (pace == "recorded")
+                    options.replayRealtime = true;
+                else if (pace == "max")
+                    options.replayRealtime = false;
+                else
+                    usage(*argv);
+                break;
+            }
+#endif
             default:
                 usage(*argv);
                 break;
         }
 
+#ifndef WIN32
+    // Prefixes are only learned from cameras that were probed, so -O alone would never probe anything
+    if (options.ouiOnly && options.vendorOuis.empty()) {
+        std::cerr << "ERROR: -O needs at least one -o prefix" << std::endl;
+        usage(*argv);
+    }
+    options.maxListenSeconds = std::max(options.maxListenSeconds, options.listenSeconds);
+    // Replaying a capture file does not touch any adapters
+    if (getuid() != 0 && options.replayFile.empty()) {
+        std::cerr << "ERROR: This program must be run with root privileges" << std::endl;
+        exit(1);
+    }
+#endif
+
 #ifdef WIN32
     AutoConnectWindows  autoConnect(runWithIpc, logToConsole);
 #else
-    AutoConnectLinux autoConnect(runWithIpc, logToConsole);
+    AutoConnectLinux autoConnect(runWithIpc, logToConsole, options);
 #endif
     while (autoConnect.pollEvents() && !stopProgram) {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
@@ -0,0 +1,203 @@
+/**
+ * @file: AutoConnect/src/Netlink.cpp
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "AutoConnect/Netlink.h"
+
+namespace AutoConnect {
+
+    Netlink::~Netlink() {
+        close();
+    }
+
+    bool Netlink::open(uint32_t groups) {
+        close();
+        m_Error.clear();
+        if ((m_Fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE)) < 0) {
+            setError("socket(AF_NETLINK)");
+            return false;
+        }
+        struct sockaddr_nl addr{};
+        addr.nl_family = AF_NETLINK;
+        addr.nl_groups = groups;
+        if (bind(m_Fd, (struct sockaddr *) &addr, sizeof(addr)) == -1) {
+            setError("bind(AF_NETLINK)");
+            close();
+            return false;
+        }
+        m_Buffer.resize(NETLINK_BUFFER_SIZE);
+        return true;
+    }
+
+    void Netlink::close() {
+        if (m_Fd >= 0) {
+            ::close(m_Fd);
+            m_Fd = -1;
+        }
+    }
+
+    bool Netlink::dump(uint16_t type, const void *header, size_t length, MessageCallback callback, void *ctx) {
+        if (m_Fd < 0)
+            return false;
+        std::vector<uint8_t> request(NLMSG_SPACE(length), 0);
+        auto *message = reinterpret_cast<struct nlmsghdr *>(request.data());
+        message->nlmsg_len = NLMSG_LENGTH(length);
+        message->nlmsg_type = type;
+        message->nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+        message->nlmsg_seq = ++m_Sequence;
+        memcpy(NLMSG_DATA(message), header, length);
+        if (send(m_Fd, request.data(), message->nlmsg_len, 0) < 0) {
+            setError("send");
+            return false;
+        }
+
+        while (true) {
+            auto received = recv(m_Fd, m_Buffer.data(), m_Buffer.size(), 0);
+            if (received < 0) {
+                if (errno == EINTR)
+                    continue;
+                setError("recv");
+                return false;
+            }
+            auto remaining = (size_t) received;
+            for (auto *reply = reinterpret_cast<struct nlmsghdr *>(m_Buffer.data());
+                 NLMSG_OK(reply, remaining); reply = NLMSG_NEXT(reply, remaining)) {
+                bool ours = reply->nlmsg_seq == m_Sequence;
+                if (ours && reply->nlmsg_type == NLMSG_DONE)
+                    return true;
+                if (ours && reply->nlmsg_type == NLMSG_ERROR) {
+                    errno = -static_cast<struct nlmsgerr *>(NLMSG_DATA(reply))->error;
+                    setError("dump");
+                    return false;
+                }
+                callback(ctx, reply);
+            }
+        }
+    }
+
+    bool Netlink::request(uint16_t type, uint16_t flags, const std::vector<uint8_t> &payload) {
+        if (m_Fd < 0)
+            return false;
+        std::vector<uint8_t> request(NLMSG_SPACE(payload.size()), 0);
+        auto *message = reinterpret_cast<struct nlmsghdr *>(request.data());
+        message->nlmsg_len = NLMSG_LENGTH(payload.size());
+        message->nlmsg_type = type;
+        message->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK | flags;
+        message->nlmsg_seq = ++m_Sequence;
+        memcpy(NLMSG_DATA(message), payload.data(), payload.size());
+        if (send(m_Fd, request.data(), message->nlmsg_len, 0) < 0) {
+            setError("send");
+            return false;
+        }
+
+        // Notifications from subscribed groups may arrive before the acknowledgement and are skipped
+        while (true) {
+            auto received = recv(m_Fd, m_Buffer.data(), m_Buffer.size(), 0);
+            if (received < 0) {
+                if (errno == EINTR)
+                    continue;
+                setError("recv");
+                return false;
+            }
+            auto remaining = (size_t) received;
+            for (auto *reply = reinterpret_cast<struct nlmsghdr *>(m_Buffer.data());
+                 NLMSG_OK(reply, remaining); reply = NLMSG_NEXT(reply, remaining)) {
+                if (reply->nlmsg_seq != m_Sequence || reply->nlmsg_type != NLMSG_ERROR)
+                    continue;
+                int error = static_cast<struct nlmsgerr *>(NLMSG_DATA(reply))->error;
+                if (error == 0)
+                    return true;
+                errno = -error;
+                setError("request");
+                return false;
+            }
+        }
+    }
+
+    int Netlink::read(MessageCallback callback, void *ctx) {
+        if (m_Fd < 0)
+            return -1;
+        int messages = 0;
+        while (true) {
+            auto received = recv(m_Fd, m_Buffer.data(), m_Buffer.size(), MSG_DONTWAIT);
+            if (received < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                    return messages;
+                // ENOBUFS means notifications were lost, the caller has to resynchronize with a dump
+                setError("recv");
+                return -1;
+            }
+            auto remaining = (size_t) received;
+            for (auto *message = reinterpret_cast<struct nlmsghdr *>(m_Buffer.data());
+                 NLMSG_OK(message, remaining); message = NLMSG_NEXT(message, remaining)) {
+                callback(ctx, message);
+                ++messages;
+            }
+        }
+    }
+
+    void Netlink::parseAttributes(const struct rtattr *attribute, int length, const struct rtattr **table, int max) {
+        memset(table, 0, sizeof(*table) * (max + 1));
+        for (; RTA_OK(attribute, length); attribute = RTA_NEXT(attribute, length)) {
+            if (attribute->rta_type <= max)
+                table[attribute->rta_type] = attribute;
+        }
+    }
+
+    size_t Netlink::addAttribute(std::vector<uint8_t> &payload, uint16_t type, const void *data, size_t length) {
+        size_t offset = NLMSG_ALIGN(payload.size());
+        payload.resize(offset + RTA_SPACE(length), 0);
+        auto *attribute = reinterpret_cast<struct rtattr *>(payload.data() + offset);
+        attribute->rta_type = type;
+        attribute->rta_len = (unsigned short) RTA_LENGTH(length);
+        if (length > 0)
+            memcpy(RTA_DATA(attribute), data, length);
+        return offset;
+    }
+
+    void Netlink::endNested(std::vector<uint8_t> &payload, size_t offset) {
+        auto *attribute = reinterpret_cast<struct rtattr *>(payload.data() + offset);
+        attribute->rta_len = (unsigned short) (payload.size() - offset);
+    }
+
+    void Netlink::setError(const char *what) {
+        m_Error = std::string(what) + ": " + strerror(errno);
+    }
+}
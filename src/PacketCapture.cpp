@@ -0,0 +1,545 @@
+/**
+ * @file: AutoConnect/src/PacketCapture.cpp
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <arpa/inet.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <linux/filter.h>
+#include <netinet/ip.h>
+#include <netinet/icmp6.h>
+
+#include "AutoConnect/PacketCapture.h"
+#include "AutoConnect/FrameClassifier.h"
+
+namespace AutoConnect {
+
+    // Classic BPF program run by the kernel on every frame before it is queued to the socket.
+    // Accepts received ARP, IPv4 IGMP, UDP from the MultiSense control port, IPv6 with a hop-by-hop header (MLD
+    // reports) and ICMPv6 neighbor advertisements. They are truncated to CAPTURE_SNAP_LENGTH, everything else is
+    // dropped. The kernel removes the outer VLAN tag before the filter runs, the inner tag of a double tagged frame is
+    // skipped by keeping its length in X.
+    static struct sock_filter discoveryFilter[] = {
+            // Drop frames we transmit ourselves
+            BPF_STMT(BPF_LD | BPF_W | BPF_ABS, (uint32_t) (SKF_AD_OFF + SKF_AD_PKTTYPE)),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, PACKET_OUTGOING, 27, 0),
+            // Step over an inner VLAN tag
+            BPF_STMT(BPF_LDX | BPF_W | BPF_IMM, 0),
+            BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 12),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ETH_P_8021Q, 1, 0),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ETH_P_8021AD, 0, 2),
+            BPF_STMT(BPF_LDX | BPF_W | BPF_IMM, 4),
+            BPF_STMT(BPF_LD | BPF_H | BPF_IND, 12),
+            // Any ARP
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ETH_P_ARP, 19, 0),
+            // IPv6 is checked at the end
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ETH_P_IPV6, 13, 0),
+            // Otherwise the EtherType must be IPv4
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ETH_P_IP, 0, 18),
+            // IGMP
+            BPF_STMT(BPF_LD | BPF_B | BPF_IND, ETH_HLEN + 9),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_IGMP, 15, 0),
+            // UDP, first fragment only since the others have no UDP header
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_UDP, 0, 15),
+            BPF_STMT(BPF_LD | BPF_H | BPF_IND, ETH_HLEN + 6),
+            BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, 0x1fff, 13, 0),
+            // Source port behind the variable length IP header: X = tag length + IP header length
+            BPF_STMT(BPF_LD | BPF_B | BPF_IND, ETH_HLEN),
+            BPF_STMT(BPF_ALU | BPF_AND | BPF_K, 0x0f),
+            BPF_STMT(BPF_ALU | BPF_LSH | BPF_K, 2),
+            BPF_STMT(BPF_ALU | BPF_ADD | BPF_X, 0),
+            BPF_STMT(BPF_MISC | BPF_TAX, 0),
+            BPF_STMT(BPF_LD | BPF_H | BPF_IND, ETH_HLEN),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, MULTISENSE_CONTROL_PORT, 5, 6),
+            // IPv6: a hop-by-hop header, or ICMPv6 right behind the fixed header
+            BPF_STMT(BPF_LD | BPF_B | BPF_IND, ETH_HLEN + 6),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_HOPOPTS, 3, 0),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_ICMPV6, 0, 3),
+            BPF_STMT(BPF_LD | BPF_B | BPF_IND, ETH_HLEN + 40),
+            BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ND_NEIGHBOR_ADVERT, 0, 1),
+            BPF_STMT(BPF_RET | BPF_K, CAPTURE_SNAP_LENGTH),
+            BPF_STMT(BPF_RET | BPF_K, 0),
+    };
+
+    PacketCapture::~PacketCapture() {
+        close();
+    }
+
+    bool PacketCapture::open(uint32_t ifIndex, const Config &config) {
+        close();
+        m_Error.clear();
+        Mode mode = config.mode;
+        if (mode == Mode::Xdp) {
+            m_Xdp = std::make_unique<XdpCapture>();
+            if (m_Xdp->open(ifIndex, config.xdpNative)) {
+                m_Mode = Mode::Xdp;
+                if (config.busyPollUsecs != 0) {
+                    m_BusyPoll = m_Xdp->enableBusyPoll(config.busyPollUsecs, config.batchSize);
+                    if (!m_BusyPoll)
+                        m_Error = "AF_XDP " + m_Xdp->errorMessage();
+                }
+                return true;
+            }
+            m_Error = "AF_XDP " + m_Xdp->errorMessage();
+            m_Xdp.reset();
+            mode = Mode::Auto;
+        }
+
+        // Protocol 0 means the socket receives nothing until it is bound,
+        // so no frames from other interfaces are queued while the ring is being set up
+        if ((m_Fd = socket(PF_PACKET, SOCK_RAW, 0)) < 0) {
+            setError("socket");
+            return false;
+        }
+
+        // Not fatal, onFrame() checks the protocol as well. The kernel just queues a lot more frames to us
+        m_Filtered = attachFilter();
+
+        // A ring block is only handed over when it is full or retires, which would undo what busy polling gains
+        if (mode == Mode::Auto && config.busyPollUsecs != 0)
+            mode = Mode::Batch;
+
+        if (mode == Mode::Copy) {
+            m_Buffer.resize(IP_MAXPACKET + 1);
+            m_Control.assign(CAPTURE_CONTROL_SIZE, 0);
+        } else if (mode != Mode::Batch && setupRing()) {
+            mode = Mode::Ring;
+        } else {
+            setupBatch(config.batchSize);
+            mode = Mode::Batch;
+        }
+        m_Mode = mode;
+        // The ring reports removed VLAN tags in each frame header, the other modes need them as ancillary data.
+        // Not fatal, frames then just look untagged
+        // The same goes for receive timestamps, which the ring always has
+        int enable = 1;
+        if (mode != Mode::Ring) {
+            setsockopt(m_Fd, SOL_PACKET, PACKET_AUXDATA, &enable, sizeof(enable));
+            setsockopt(m_Fd, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable));
+        }
+
+        struct sockaddr_ll addr{};
+        addr.sll_family = AF_PACKET;
+        addr.sll_protocol = htons(ETH_P_ALL);
+        addr.sll_ifindex = (int) ifIndex;
+        if (bind(m_Fd, (struct sockaddr *) &addr, sizeof(addr)) == -1) {
+            setError("bind");
+            close();
+            return false;
+        }
+        // Must come after bind, the group is tied to the interface and protocol of the first member
+        if (config.fanoutGroup != 0 && !joinFanout(config.fanoutGroup, config.fanoutMode)) {
+            close();
+            return false;
+        }
+        // Not fatal, the socket just sleeps in poll() as usual
+        if (config.busyPollUsecs != 0)
+            m_BusyPoll = enableBusyPoll(config.busyPollUsecs, config.batchSize);
+        return true;
+    }
+
+    bool PacketCapture::enableBusyPoll(uint32_t usecs, uint32_t budget) {
+        int value = (int) usecs;
+        if (setsockopt(m_Fd, SOL_SOCKET, SO_BUSY_POLL, &value, sizeof(value)) == -1) {
+            setError("setsockopt(SO_BUSY_POLL)");
+            return false;
+        }
+        // Both only tune the busy poll loop and are missing before Linux 5.11
+        value = 1;
+        setsockopt(m_Fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &value, sizeof(value));
+        value = (int) std::max<uint32_t>(budget, 1);
+        setsockopt(m_Fd, SOL_SOCKET, SO_BUSY_POLL_BUDGET, &value, sizeof(value));
+
+        // poll() receives blocking in this mode so the kernel can busy poll inside the receive call
+        struct timeval timeout{};
+        timeout.tv_usec = CAPTURE_BUSY_POLL_TIMEOUT_MS * 1000;
+        if (setsockopt(m_Fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == -1) {
+            setError("setsockopt(SO_RCVTIMEO)");
+            return false;
+        }
+        return true;
+    }
+
+    bool PacketCapture::joinFanout(uint16_t group, Fanout fanout) {
+        // Reassemble IP fragments before hashing so all fragments of a datagram go to the same socket
+        uint32_t type = fanout == Fanout::Cpu ? PACKET_FANOUT_CPU : PACKET_FANOUT_HASH | PACKET_FANOUT_FLAG_DEFRAG;
+        int arg = (int) (group | (type << 16));
+        if (setsockopt(m_Fd, SOL_PACKET, PACKET_FANOUT, &arg, sizeof(arg)) == -1) {
+            setError("setsockopt(PACKET_FANOUT)");
+            return false;
+        }
+        return true;
+    }
+
+    bool PacketCapture::attachFilter() {
+        struct sock_fprog program{};
+        program.len = sizeof(discoveryFilter) / sizeof(discoveryFilter[0]);
+        program.filter = discoveryFilter;
+        if (setsockopt(m_Fd, SOL_SOCKET, SO_ATTACH_FILTER, &program, sizeof(program)) == -1) {
+            setError("setsockopt(SO_ATTACH_FILTER)");
+            return false;
+        }
+        return true;
+    }
+
+    bool PacketCapture::setupRing() {
+        int version = TPACKET_V3;
+        if (setsockopt(m_Fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) == -1) {
+            setError("setsockopt(PACKET_VERSION)");
+            return false;
+        }
+
+        struct tpacket_req3 req{};
+        req.tp_block_size = CAPTURE_BLOCK_SIZE;
+        req.tp_block_nr = CAPTURE_BLOCK_COUNT;
+        req.tp_frame_size = CAPTURE_FRAME_SIZE;
+        req.tp_frame_nr = (CAPTURE_BLOCK_SIZE / CAPTURE_FRAME_SIZE) * CAPTURE_BLOCK_COUNT;
+        req.tp_retire_blk_tov = CAPTURE_BLOCK_TIMEOUT_MS;
+        if (setsockopt(m_Fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) == -1) {
+            setError("setsockopt(PACKET_RX_RING)");
+            return false;
+        }
+
+        m_RingSize = (size_t) req.tp_block_size * req.tp_block_nr;
+        void *ring = mmap(nullptr, m_RingSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_Fd, 0);
+        if (ring == MAP_FAILED) {
+            setError("mmap");
+            m_RingSize = 0;
+            // Frames would be queued to an unmapped ring, so tear it down again to make recv() work
+            req = {};
+            setsockopt(m_Fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req));
+            return false;
+        }
+        m_Ring = static_cast<uint8_t *>(ring);
+        m_CurrentBlock = 0;
+        return true;
+    }
+
+    void PacketCapture::setupBatch(uint32_t batchSize) {
+        batchSize = std::max<uint32_t>(batchSize, 1);
+        // Frames longer than a slot are truncated, which is fine since only the headers are looked at
+        m_Buffer.assign((size_t) batchSize * CAPTURE_FRAME_SIZE, 0);
+        m_Iovecs.resize(batchSize);
+        m_Messages.resize(batchSize);
+        m_Control.assign((size_t) batchSize * CAPTURE_CONTROL_SIZE, 0);
+        for (uint32_t i = 0; i < batchSize; ++i) {
+            m_Iovecs[i].iov_base = m_Buffer.data() + (size_t) i * CAPTURE_FRAME_SIZE;
+            m_Iovecs[i].iov_len = CAPTURE_FRAME_SIZE;
+            m_Messages[i] = {};
+            m_Messages[i].msg_hdr.msg_iov = &m_Iovecs[i];
+            m_Messages[i].msg_hdr.msg_iovlen = 1;
+            m_Messages[i].msg_hdr.msg_control = m_Control.data() + (size_t) i * CAPTURE_CONTROL_SIZE;
+        }
+    }
+
+    void PacketCapture::close() {
+        if (m_Ring != nullptr) {
+            munmap(m_Ring, m_RingSize);
+            m_Ring = nullptr;
+            m_RingSize = 0;
+        }
+        if (m_Fd >= 0) {
+            ::close(m_Fd);
+            m_Fd = -1;
+        }
+        m_Buffer.clear();
+        m_Iovecs.clear();
+        m_Messages.clear();
+        m_Control.clear();
+        m_Xdp.reset();
+        m_Filtered = false;
+        m_BusyPoll = false;
+        m_Mode = Mode::Auto;
+        m_Frames = 0;
+        m_Bytes = 0;
+        m_Syscalls = 0;
+        m_KernelPackets = 0;
+        m_KernelDrops = 0;
+    }
+
+    int PacketCapture::poll(int timeoutMs, FrameCallback callback, void *ctx) {
+        if (fd() < 0)
+            return -1;
+
+        // Skip the wait if the kernel has already handed us a block
+        if (m_Ring != nullptr) {
+            auto *block = reinterpret_cast<tpacket_block_desc *>(m_Ring + (size_t) m_CurrentBlock * CAPTURE_BLOCK_SIZE);
+            if (__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER)
+                return readRing(callback, ctx);
+        }
+
+        // Block in the receive call itself, bounded by SO_RCVTIMEO. Unlike poll(), a blocking recvmmsg() busy polls
+        // the device queue without the net.core.busy_poll sysctl
+        if (m_BusyPoll && m_Mode == Mode::Batch && timeoutMs > 0)
+            return readBatch(callback, ctx, true);
+
+        struct pollfd pfd{};
+        pfd.fd = fd();
+        pfd.events = POLLIN | POLLERR;
+        int res = ::poll(&pfd, 1, timeoutMs);
+        if (res < 0) {
+            if (errno == EINTR)
+                return 0;
+            setError("poll");
+            return -1;
+        }
+        if (res == 0)
+            return 0;
+
+        return read(callback, ctx);
+    }
+
+    int PacketCapture::read(FrameCallback callback, void *ctx) {
+        if (fd() < 0)
+            return -1;
+        switch (m_Mode) {
+            case Mode::Xdp:
+                return readXdp(callback, ctx);
+            case Mode::Ring:
+                return readRing(callback, ctx);
+            case Mode::Batch:
+                return readBatch(callback, ctx);
+            default:
+                return readSocket(callback, ctx);
+        }
+    }
+
+    PacketCapture::Statistics PacketCapture::statistics() {
+        if (m_Xdp) {
+            // AF_XDP counters are not reset when read
+            m_KernelDrops = m_Xdp->drops();
+        } else if (m_Fd >= 0) {
+            // The kernel resets its counters on every read. tp_packets includes the dropped frames.
+            // Sockets without a V3 ring only fill in the first two fields
+            struct tpacket_stats_v3 stats{};
+            socklen_t length = sizeof(stats);
+            if (getsockopt(m_Fd, SOL_PACKET, PACKET_STATISTICS, &stats, &length) == 0) {
+                m_KernelPackets += stats.tp_packets;
+                m_KernelDrops += stats.tp_drops;
+            }
+        }
+        Statistics statistics;
+        statistics.frames = m_Frames;
+        statistics.bytes = m_Bytes;
+        statistics.kernelPackets = m_Xdp ? m_Frames + m_KernelDrops : m_KernelPackets;
+        statistics.kernelDrops = m_KernelDrops;
+        return statistics;
+    }
+
+    void PacketCapture::deliver(const uint8_t *data, uint32_t length, FrameCallback callback, void *ctx) {
+        Frame frame;
+        frame.data = data;
+        frame.length = length;
+        frame.timestampNs = realtimeNs();
+        callback(ctx, frame);
+        ++m_Frames;
+        m_Bytes += length;
+    }
+
+    void PacketCapture::deliver(struct msghdr &message, uint32_t length, FrameCallback callback, void *ctx) {
+        Frame frame;
+        frame.data = static_cast<const uint8_t *>(message.msg_iov[0].iov_base);
+        frame.length = length;
+        parseControl(message, frame);
+        callback(ctx, frame);
+        ++m_Frames;
+        m_Bytes += length;
+    }
+
+    int PacketCapture::readRing(FrameCallback callback, void *ctx) {
+        int frames = 0;
+        while (true) {
+            auto *block = reinterpret_cast<tpacket_block_desc *>(m_Ring + (size_t) m_CurrentBlock * CAPTURE_BLOCK_SIZE);
+            if (!(__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER))
+                break;
+
+            auto *hdr = reinterpret_cast<tpacket3_hdr *>(reinterpret_cast<uint8_t *>(block) +
+                                                         block->hdr.bh1.offset_to_first_pkt);
+            for (uint32_t i = 0; i < block->hdr.bh1.num_pkts; ++i) {
+                Frame frame;
+                frame.data = reinterpret_cast<const uint8_t *>(hdr) + hdr->tp_mac;
+                frame.length = hdr->tp_snaplen;
+                frame.timestampNs = (uint64_t) hdr->tp_sec * 1000000000 + hdr->tp_nsec;
+                if (hdr->tp_status & TP_STATUS_VLAN_VALID) {
+                    frame.vlan.tci = (uint16_t) hdr->hv1.tp_vlan_tci;
+                    frame.vlan.protocol = hdr->tp_status & TP_STATUS_VLAN_TPID_VALID ? hdr->hv1.tp_vlan_tpid
+                                                                                     : ETH_P_8021Q;
+                }
+                callback(ctx, frame);
+                ++frames;
+                ++m_Frames;
+                m_Bytes += frame.length;
+                hdr = reinterpret_cast<tpacket3_hdr *>(reinterpret_cast<uint8_t *>(hdr) + hdr->tp_next_offset);
+            }
+            // Give the block back to the kernel
+            __atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+            m_CurrentBlock = (m_CurrentBlock + 1) % CAPTURE_BLOCK_COUNT;
+        }
+        return frames;
+    }
+
+    int PacketCapture::readBatch(FrameCallback callback, void *ctx, bool wait) {
+        int frames = 0;
+        while (frames < CAPTURE_MAX_FRAMES_PER_READ) {
+            // Only the first call may wait, and only for the first frame
+            int flags = wait && frames == 0 ? MSG_WAITFORONE : MSG_DONTWAIT;
+            // The kernel shrinks msg_controllen to what it wrote
+            for (auto &message: m_Messages)
+                message.msg_hdr.msg_controllen = CAPTURE_CONTROL_SIZE;
+            int received = recvmmsg(m_Fd, m_Messages.data(), (unsigned int) m_Messages.size(), flags, nullptr);
+            ++m_Syscalls;
+            if (received < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                    break;
+                setError("recvmmsg");
+                return -1;
+            }
+            for (int i = 0; i < received; ++i) {
+                Frame frame;
+                frame.data = static_cast<const uint8_t *>(m_Iovecs[i].iov_base);
+                frame.length = m_Messages[i].msg_len;
+                parseControl(m_Messages[i].msg_hdr, frame);
+                callback(ctx, frame);
+                m_Bytes += frame.length;
+            }
+            frames += received;
+            m_Frames += received;
+            // A short batch means the queue is drained, no need to ask again
+            if (received < (int) m_Messages.size())
+                break;
+        }
+        return frames;
+    }
+
+    int PacketCapture::readSocket(FrameCallback callback, void *ctx) {
+        int frames = 0;
+        // Drain what is queued, but give the caller control back once in a while on a busy link
+        struct iovec iov{m_Buffer.data(), m_Buffer.size()};
+        struct msghdr message{};
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = m_Control.data();
+        while (frames < CAPTURE_MAX_FRAMES_PER_READ) {
+            message.msg_controllen = m_Control.size();
+            auto size = recvmsg(m_Fd, &message, MSG_DONTWAIT);
+            ++m_Syscalls;
+            if (size < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                    break;
+                setError("recvmsg");
+                return -1;
+            }
+            Frame frame;
+            frame.data = m_Buffer.data();
+            frame.length = (uint32_t) size;
+            parseControl(message, frame);
+            callback(ctx, frame);
+            ++frames;
+            ++m_Frames;
+            m_Bytes += frame.length;
+        }
+        return frames;
+    }
+
+    void PacketCapture::parseControl(struct msghdr &message, Frame &frame) {
+        for (auto *cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS &&
+                cmsg->cmsg_len >= CMSG_LEN(sizeof(struct timespec))) {
+                struct timespec timestamp{};
+                memcpy(&timestamp, CMSG_DATA(cmsg), sizeof(timestamp));
+                frame.timestampNs = (uint64_t) timestamp.tv_sec * 1000000000 + (uint64_t) timestamp.tv_nsec;
+            }
+            if (cmsg->cmsg_level != SOL_PACKET || cmsg->cmsg_type != PACKET_AUXDATA ||
+                cmsg->cmsg_len < CMSG_LEN(sizeof(struct tpacket_auxdata)))
+                continue;
+            struct tpacket_auxdata auxiliary{};
+            memcpy(&auxiliary, CMSG_DATA(cmsg), sizeof(auxiliary));
+            if (auxiliary.tp_status & TP_STATUS_VLAN_VALID) {
+                frame.vlan.tci = auxiliary.tp_vlan_tci;
+                frame.vlan.protocol = auxiliary.tp_status & TP_STATUS_VLAN_TPID_VALID ? auxiliary.tp_vlan_tpid
+                                                                                      : ETH_P_8021Q;
+            }
+        }
+        // Without the timestamp option the frame is as old as this read
+        if (frame.timestampNs == 0)
+            frame.timestampNs = realtimeNs();
+    }
+
+    uint64_t PacketCapture::realtimeNs() {
+        struct timespec now{};
+        clock_gettime(CLOCK_REALTIME, &now);
+        return (uint64_t) now.tv_sec * 1000000000 + (uint64_t) now.tv_nsec;
+    }
+
+    int PacketCapture::readXdp(FrameCallback callback, void *ctx) {
+        struct Forward {
+            PacketCapture *capture;
+            FrameCallback callback;
+            void *ctx;
+        } forward{this, callback, ctx};
+        return m_Xdp->read([](void *forwardCtx, const uint8_t *data, uint32_t length) {
+            auto *f = static_cast<Forward *>(forwardCtx);
+            f->capture->deliver(data, length, f->callback, f->ctx);
+        }, &forward);
+    }
+
+    const char *PacketCapture::modeName(Mode mode) {
+        switch (mode) {
+            case Mode::Xdp:
+                return "xdp";
+            case Mode::Ring:
+                return "ring";
+            case Mode::Batch:
+                return "batch";
+            case Mode::Copy:
+                return "copy";
+            default:
+                return "auto";
+        }
+    }
+
+    void PacketCapture::setError(const char *what) {
+        m_Error = std::string(what) + ": " + strerror(errno);
+    }
+}
@@ -0,0 +1,149 @@
+/**
+ * @file: AutoConnect/src/PcapReader.cpp
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#include <cerrno>
+#include <cstring>
+
+#include "AutoConnect/PcapReader.h"
+
+#define PCAP_MAGIC_MICROSECONDS 0xa1b2c3d4
+#define PCAP_MAGIC_NANOSECONDS 0xa1b23c4d
+#define LINKTYPE_ETHERNET 1
+#define LINKTYPE_LINUX_SLL 113
+#define SLL_HEADER_LENGTH 16
+// Sanity limit for a single record, larger values mean the file is corrupt
+#define PCAP_MAX_RECORD_LENGTH (256 * 1024)
+
+namespace AutoConnect {
+
+    struct PcapFileHeader {
+        uint32_t magic;
+        uint16_t versionMajor;
+        uint16_t versionMinor;
+        int32_t thisZone;
+        uint32_t sigFigs;
+        uint32_t snapLength;
+        uint32_t linkType;
+    };
+
+    struct PcapRecordHeader {
+        uint32_t seconds;
+        uint32_t fraction;
+        uint32_t capturedLength;
+        uint32_t originalLength;
+    };
+
+    PcapReader::~PcapReader() {
+        if (m_File != nullptr)
+            fclose(m_File);
+    }
+
+    bool PcapReader::open(const std::string &path) {
+        if ((m_File = fopen(path.c_str(), "rb")) == nullptr) {
+            m_Error = "Cannot open " + path + ": " + strerror(errno);
+            return false;
+        }
+        PcapFileHeader header{};
+        if (fread(&header, sizeof(header), 1, m_File) != 1) {
+            m_Error = path + " is too short to be a pcap file";
+            return false;
+        }
+        if (header.magic == PCAP_MAGIC_MICROSECONDS || header.magic == PCAP_MAGIC_NANOSECONDS) {
+            m_Swapped = false;
+        } else if (__builtin_bswap32(header.magic) == PCAP_MAGIC_MICROSECONDS ||
+                   __builtin_bswap32(header.magic) == PCAP_MAGIC_NANOSECONDS) {
+            m_Swapped = true;
+        } else {
+            m_Error = path + " is not a pcap file (pcapng is not supported, convert it with editcap -F pcap)";
+            return false;
+        }
+        m_Nanoseconds = toHost(header.magic) == PCAP_MAGIC_NANOSECONDS;
+        m_LinkType = toHost(header.linkType);
+        if (m_LinkType != LINKTYPE_ETHERNET && m_LinkType != LINKTYPE_LINUX_SLL) {
+            m_Error = path + " has unsupported link type " + std::to_string(m_LinkType);
+            return false;
+        }
+        return true;
+    }
+
+    bool PcapReader::next(Packet &packet) {
+        if (m_File == nullptr)
+            return false;
+        PcapRecordHeader record{};
+        if (fread(&record, sizeof(record), 1, m_File) != 1) {
+            if (ferror(m_File))
+                m_Error = std::string("Failed to read pcap record: ") + strerror(errno);
+            return false;
+        }
+        uint32_t length = toHost(record.capturedLength);
+        if (length > PCAP_MAX_RECORD_LENGTH) {
+            m_Error = "Corrupt pcap record of " + std::to_string(length) + " bytes";
+            return false;
+        }
+        m_Buffer.resize(length);
+        if (length > 0 && fread(m_Buffer.data(), length, 1, m_File) != 1) {
+            m_Error = "Truncated pcap record";
+            return false;
+        }
+
+        packet.data = m_Buffer.data();
+        packet.length = length;
+        if (m_LinkType == LINKTYPE_LINUX_SLL) {
+            if (length < SLL_HEADER_LENGTH) {
+                packet.length = 0;
+            } else {
+                // Cooked header: packet type, ARPHRD type, address length, 8 byte address, protocol.
+                // Turn the last 14 bytes into an Ethernet header with the sender as source address.
+                uint8_t source[6];
+                memcpy(source, m_Buffer.data() + 6, sizeof(source));
+                uint8_t *ethernet = m_Buffer.data() + SLL_HEADER_LENGTH - 14;
+                memset(ethernet, 0x00, 6);
+                memcpy(ethernet + 6, source, sizeof(source));
+                packet.data = ethernet;
+                packet.length = length - (SLL_HEADER_LENGTH - 14);
+            }
+        }
+
+        auto fraction = static_cast<int64_t>(toHost(record.fraction));
+        packet.timestamp = std::chrono::seconds(toHost(record.seconds)) +
+                           (m_Nanoseconds ? std::chrono::nanoseconds(fraction) : std::chrono::microseconds(fraction));
+        return true;
+    }
+
+    uint32_t PcapReader::toHost(uint32_t value) const {
+        return m_Swapped ? __builtin_bswap32(value) : value;
+    }
+}
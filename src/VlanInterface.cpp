@@ -0,0 +1,165 @@
+/**
+ * @file: AutoConnect/src/VlanInterface.cpp
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#include <cstring>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <linux/if_ether.h>
+#include <linux/if_link.h>
+
+#include "AutoConnect/VlanInterface.h"
+#include "AutoConnect/Netlink.h"
+
+namespace AutoConnect {
+
+    struct VlanSearch {
+        uint32_t parentIndex;
+        uint16_t vlanId;
+        uint16_t protocol;
+        VlanInterface::Link *link;
+    };
+
+    static void matchVlan(void *ctx, const struct nlmsghdr *message) {
+        auto *search = static_cast<VlanSearch *>(ctx);
+        if (message->nlmsg_type != RTM_NEWLINK || search->link->ifIndex != 0)
+            return;
+        auto *info = static_cast<const struct ifinfomsg *>(NLMSG_DATA(message));
+        const struct rtattr *attributes[IFLA_MAX + 1];
+        Netlink::parseAttributes(IFLA_RTA(info), (int) IFLA_PAYLOAD(message), attributes, IFLA_MAX);
+        if (attributes[IFLA_LINK] == nullptr || attributes[IFLA_IFNAME] == nullptr ||
+            attributes[IFLA_LINKINFO] == nullptr ||
+            *static_cast<const uint32_t *>(RTA_DATA(attributes[IFLA_LINK])) != search->parentIndex)
+            return;
+
+        const struct rtattr *linkInfo[IFLA_INFO_MAX + 1];
+        Netlink::parseAttributes(static_cast<const struct rtattr *>(RTA_DATA(attributes[IFLA_LINKINFO])),
+                                 (int) RTA_PAYLOAD(attributes[IFLA_LINKINFO]), linkInfo, IFLA_INFO_MAX);
+        if (linkInfo[IFLA_INFO_KIND] == nullptr || linkInfo[IFLA_INFO_DATA] == nullptr ||
+            strncmp(static_cast<const char *>(RTA_DATA(linkInfo[IFLA_INFO_KIND])), "vlan",
+                    RTA_PAYLOAD(linkInfo[IFLA_INFO_KIND])) != 0)
+            return;
+
+        const struct rtattr *vlan[IFLA_VLAN_MAX + 1];
+        Netlink::parseAttributes(static_cast<const struct rtattr *>(RTA_DATA(linkInfo[IFLA_INFO_DATA])),
+                                 (int) RTA_PAYLOAD(linkInfo[IFLA_INFO_DATA]), vlan, IFLA_VLAN_MAX);
+        if (vlan[IFLA_VLAN_ID] == nullptr ||
+            *static_cast<const uint16_t *>(RTA_DATA(vlan[IFLA_VLAN_ID])) != search->vlanId)
+            return;
+        // The protocol attribute is in network byte order and missing on old kernels, which only know 802.1Q
+        uint16_t protocol = vlan[IFLA_VLAN_PROTOCOL] != nullptr ?
+                            ntohs(*static_cast<const uint16_t *>(RTA_DATA(vlan[IFLA_VLAN_PROTOCOL]))) : ETH_P_8021Q;
+        if (protocol != search->protocol)
+            return;
+        search->link->ifIndex = (uint32_t) info->ifi_index;
+        search->link->ifName = static_cast<const char *>(RTA_DATA(attributes[IFLA_IFNAME]));
+    }
+
+    // Interface names are limited to IFNAMSIZ - 1 characters, long parent names get a name from the parent index
+    static std::string vlanName(uint32_t parentIndex, const std::string &parentName, uint16_t vlanId) {
+        std::string name = parentName + "." + std::to_string(vlanId);
+        if (name.size() < IFNAMSIZ)
+            return name;
+        return "ac" + std::to_string(parentIndex) + "." + std::to_string(vlanId);
+    }
+
+    bool VlanInterface::acquire(uint32_t parentIndex, const std::string &parentName, uint16_t vlanId, uint16_t protocol,
+                                Link &link, std::string &error) {
+        link = {};
+        Netlink netlink;
+        if (!netlink.open()) {
+            error = netlink.errorMessage();
+            return false;
+        }
+        VlanSearch search{parentIndex, vlanId, protocol, &link};
+        struct ifinfomsg dumpRequest{};
+        dumpRequest.ifi_family = AF_UNSPEC;
+        if (!netlink.dump(RTM_GETLINK, &dumpRequest, sizeof(dumpRequest), matchVlan, &search)) {
+            error = netlink.errorMessage();
+            return false;
+        }
+
+        // Bring it up as well if it exists but is down, the flags are applied to an existing link too
+        std::string name = link.ifIndex != 0 ? link.ifName : vlanName(parentIndex, parentName, vlanId);
+        std::vector<uint8_t> payload(sizeof(struct ifinfomsg), 0);
+        auto *info = reinterpret_cast<struct ifinfomsg *>(payload.data());
+        info->ifi_family = AF_UNSPEC;
+        info->ifi_index = (int) link.ifIndex;
+        info->ifi_flags = IFF_UP;
+        info->ifi_change = IFF_UP;
+        uint16_t flags = 0;
+        if (link.ifIndex == 0) {
+            uint32_t parent = parentIndex;
+            uint16_t networkProtocol = htons(protocol);
+            Netlink::addAttribute(payload, IFLA_LINK, &parent, sizeof(parent));
+            Netlink::addAttribute(payload, IFLA_IFNAME, name.c_str(), name.size() + 1);
+            size_t linkInfo = Netlink::addAttribute(payload, IFLA_LINKINFO, nullptr, 0);
+            Netlink::addAttribute(payload, IFLA_INFO_KIND, "vlan", 4);
+            size_t data = Netlink::addAttribute(payload, IFLA_INFO_DATA, nullptr, 0);
+            Netlink::addAttribute(payload, IFLA_VLAN_ID, &vlanId, sizeof(vlanId));
+            Netlink::addAttribute(payload, IFLA_VLAN_PROTOCOL, &networkProtocol, sizeof(networkProtocol));
+            Netlink::endNested(payload, data);
+            Netlink::endNested(payload, linkInfo);
+            flags = NLM_F_CREATE | NLM_F_EXCL;
+        }
+        if (!netlink.request(RTM_NEWLINK, flags, payload)) {
+            error = netlink.errorMessage();
+            return false;
+        }
+        if (link.ifIndex == 0) {
+            link.ifName = name;
+            link.ifIndex = if_nametoindex(name.c_str());
+            link.created = true;
+        }
+        return link.ifIndex != 0;
+    }
+
+    bool VlanInterface::remove(const Link &link, std::string &error) {
+        Netlink netlink;
+        if (!netlink.open()) {
+            error = netlink.errorMessage();
+            return false;
+        }
+        std::vector<uint8_t> payload(sizeof(struct ifinfomsg), 0);
+        auto *info = reinterpret_cast<struct ifinfomsg *>(payload.data());
+        info->ifi_family = AF_UNSPEC;
+        info->ifi_index = (int) link.ifIndex;
+        if (!netlink.request(RTM_DELLINK, 0, payload)) {
+            error = netlink.errorMessage();
+            return false;
+        }
+        return true;
+    }
+}
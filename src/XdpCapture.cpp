@@ -0,0 +1,422 @@
+/**
+ * @file: AutoConnect/src/XdpCapture.cpp
+ *
+ * Copyright 2022
+ * Carnegie Robotics, LLC
+ * 4501 Hatfield Street, Pittsburgh, PA 15201
+ * http://www.carnegierobotics.com
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the Carnegie Robotics, LLC nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL CARNEGIE ROBOTICS, LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * Significant history (date, user, action):
+ *   2026-10-16, agent@local, Created file.
+ **/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <arpa/inet.h>
+#include <linux/bpf.h>
+#include <linux/if_ether.h>
+#include <linux/if_link.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#include "AutoConnect/XdpCapture.h"
+
+#ifndef AF_XDP
+#define AF_XDP 44
+#endif
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+
+namespace AutoConnect {
+
+    static int bpf(enum bpf_cmd cmd, union bpf_attr *attr) {
+        return (int) syscall(__NR_bpf, cmd, attr, sizeof(*attr));
+    }
+
+    static struct bpf_insn instruction(uint8_t code, uint8_t dst, uint8_t src, int16_t offset, int32_t imm) {
+        struct bpf_insn insn{};
+        insn.code = code;
+        insn.dst_reg = dst;
+        insn.src_reg = src;
+        insn.off = offset;
+        insn.imm = imm;
+        return insn;
+    }
+
+    XdpCapture::~XdpCapture() {
+        close();
+    }
+
+    bool XdpCapture::open(uint32_t ifIndex, bool native) {
+        close();
+        m_IfIndex = ifIndex;
+
+        // One socket per receive queue, RSS may put a camera's frames on any of them
+        char ifName[IF_NAMESIZE]{};
+        if (if_indextoname(ifIndex, ifName) == nullptr) {
+            setError("if_indextoname");
+            return false;
+        }
+        uint32_t queueCount = 0;
+        std::string queuesPath = std::string("/sys/class/net/") + ifName + "/queues";
+        if (DIR *dir = opendir(queuesPath.c_str())) {
+            while (struct dirent *entry = readdir(dir)) {
+                if (strncmp(entry->d_name, "rx-", 3) == 0)
+                    ++queueCount;
+            }
+            closedir(dir);
+        }
+        queueCount = std::max<uint32_t>(queueCount, 1);
+
+        if (!loadProgram(queueCount)) {
+            close();
+            return false;
+        }
+        if ((m_EpollFd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+            setError("epoll_create1");
+            close();
+            return false;
+        }
+        m_Queues.resize(queueCount);
+        for (uint32_t i = 0; i < queueCount; ++i) {
+            if (!openQueue(m_Queues[i], i, native)) {
+                close();
+                return false;
+            }
+        }
+
+        // Don't replace a program somebody else has attached
+        m_AttachFlags = native ? XDP_FLAGS_DRV_MODE : XDP_FLAGS_SKB_MODE;
+        if (!setLinkProgram(m_ProgramFd, m_AttachFlags | XDP_FLAGS_UPDATE_IF_NOEXIST)) {
+            close();
+            return false;
+        }
+        m_Attached = true;
+        return true;
+    }
+
+    bool XdpCapture::loadProgram(uint32_t queueCount) {
+        union bpf_attr attr{};
+        attr.map_type = BPF_MAP_TYPE_XSKMAP;
+        attr.key_size = sizeof(uint32_t);
+        attr.value_size = sizeof(uint32_t);
+        attr.max_entries = queueCount;
+        if ((m_MapFd = bpf(BPF_MAP_CREATE, &attr)) < 0) {
+            setError("bpf(BPF_MAP_CREATE)");
+            return false;
+        }
+
+        // r1 = struct xdp_md *. Redirect IPv4 IGMP to the socket of the receiving queue, pass everything else.
+        // If the queue has no socket bpf_redirect_map falls back to XDP_PASS given in the flags argument.
+        std::vector<struct bpf_insn> program = {
+                instruction(BPF_LDX | BPF_W | BPF_MEM, 2, 1, 4, 0),          // r2 = ctx->data_end
+                instruction(BPF_LDX | BPF_W | BPF_MEM, 3, 1, 0, 0),          // r3 = ctx->data
+                instruction(BPF_ALU64 | BPF_MOV | BPF_X, 4, 3, 0, 0),        // r4 = r3
+                instruction(BPF_ALU64 | BPF_ADD | BPF_K, 4, 0, 0, 34),       // r4 += Ethernet + IPv4 header
+                instruction(BPF_JMP | BPF_JGT | BPF_X, 4, 2, 10, 0),         // if r4 > data_end goto pass
+                instruction(BPF_LDX | BPF_H | BPF_MEM, 5, 3, 12, 0),         // r5 = EtherType
+                instruction(BPF_JMP | BPF_JNE | BPF_K, 5, 0, 8, htons(ETH_P_IP)), // if not IPv4 goto pass
+                instruction(BPF_LDX | BPF_B | BPF_MEM, 5, 3, 23, 0),         // r5 = IP protocol
+                instruction(BPF_JMP | BPF_JNE | BPF_K, 5, 0, 6, 2),          // if r5 != IGMP goto pass
+                instruction(BPF_LDX | BPF_W | BPF_MEM, 2, 1, 16, 0),         // r2 = ctx->rx_queue_index
+                instruction(BPF_LD | BPF_DW | BPF_IMM, 1, BPF_PSEUDO_MAP_FD, 0, m_MapFd), // r1 = map
+                instruction(0, 0, 0, 0, 0),                                  // upper half of the 64 bit load
+                instruction(BPF_ALU64 | BPF_MOV | BPF_K, 3, 0, 0, XDP_PASS), // r3 = fallback action
+                instruction(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map),
+                instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+                instruction(BPF_ALU64 | BPF_MOV | BPF_K, 0, 0, 0, XDP_PASS), // pass: r0 = XDP_PASS
+                instruction(BPF_JMP | BPF_EXIT, 0, 0, 0, 0),
+        };
+
+        static const char license[] = "Dual BSD/GPL";
+        char verifierLog[4096]{};
+        attr = {};
+        attr.prog_type = BPF_PROG_TYPE_XDP;
+        attr.insns = reinterpret_cast<uint64_t>(program.data());
+        attr.insn_cnt = static_cast<uint32_t>(program.size());
+        attr.license = reinterpret_cast<uint64_t>(license);
+        attr.log_buf = reinterpret_cast<uint64_t>(verifierLog);
+        attr.log_size = sizeof(verifierLog);
+        attr.log_level = 1;
+        if ((m_ProgramFd = bpf(BPF_PROG_LOAD, &attr)) < 0) {
+            setError("bpf(BPF_PROG_LOAD)");
+            if (verifierLog[0] != '\0')
+                m_Error += std::string(". Verifier: ") + verifierLog;
+            return false;
+        }
+        return true;
+    }
+
+    bool XdpCapture::mapRing(int fd, Ring &ring, const struct xdp_ring_offset &offsets, size_t descriptorSize,
+                             off_t pageOffset) {
+        ring.mapSize = offsets.desc + XDP_RING_SIZE * descriptorSize;
+        void *map = mmap(nullptr, ring.mapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, pageOffset);
+        if (map == MAP_FAILED) {
+            ring.map = nullptr;
+            return false;
+        }
+        ring.map = map;
+        ring.producer = reinterpret_cast<uint32_t *>(static_cast<uint8_t *>(map) + offsets.producer);
+        ring.consumer = reinterpret_cast<uint32_t *>(static_cast<uint8_t *>(map) + offsets.consumer);
+        ring.descriptors = static_cast<uint8_t *>(map) + offsets.desc;
+        return true;
+    }
+
+    bool XdpCapture::openQueue(Queue &queue, uint32_t queueId, bool native) {
+        if ((queue.fd = socket(AF_XDP, SOCK_RAW | SOCK_CLOEXEC, 0)) < 0) {
+            setError("socket(AF_XDP)");
+            return false;
+        }
+
+        void *umem = mmap(nullptr, (size_t) XDP_FRAME_COUNT * XDP_FRAME_SIZE, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (umem == MAP_FAILED) {
+            setError("mmap(UMEM)");
+            return false;
+        }
+        queue.umem = static_cast<uint8_t *>(umem);
+
+        struct xdp_umem_reg reg{};
+        reg.addr = reinterpret_cast<uint64_t>(queue.umem);
+        reg.len = (uint64_t) XDP_FRAME_COUNT * XDP_FRAME_SIZE;
+        reg.chunk_size = XDP_FRAME_SIZE;
+        if (setsockopt(queue.fd, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg)) == -1) {
+            setError("setsockopt(XDP_UMEM_REG)");
+            return false;
+        }
+        // The completion ring is only used for transmit but the kernel requires it on every UMEM
+        int size = XDP_RING_SIZE;
+        if (setsockopt(queue.fd, SOL_XDP, XDP_UMEM_FILL_RING, &size, sizeof(size)) == -1 ||
+            setsockopt(queue.fd, SOL_XDP, XDP_UMEM_COMPLETION_RING, &size, sizeof(size)) == -1 ||
+            setsockopt(queue.fd, SOL_XDP, XDP_RX_RING, &size, sizeof(size)) == -1) {
+            setError("setsockopt(XDP rings)");
+            return false;
+        }
+
+        struct xdp_mmap_offsets offsets{};
+        socklen_t optionLength = sizeof(offsets);
+        if (getsockopt(queue.fd, SOL_XDP, XDP_MMAP_OFFSETS, &offsets, &optionLength) == -1) {
+            setError("getsockopt(XDP_MMAP_OFFSETS)");
+            return false;
+        }
+        if (!mapRing(queue.fd, queue.fill, offsets.fr, sizeof(uint64_t), XDP_UMEM_PGOFF_FILL_RING) ||
+            !mapRing(queue.fd, queue.rx, offsets.rx, sizeof(struct xdp_desc), XDP_PGOFF_RX_RING)) {
+            setError("mmap(XDP rings)");
+            return false;
+        }
+
+        // Hand all frames to the kernel for receiving
+        auto *fill = static_cast<uint64_t *>(queue.fill.descriptors);
+        uint32_t producer = *queue.fill.producer;
+        for (uint32_t i = 0; i < XDP_FRAME_COUNT && i < XDP_RING_SIZE; ++i, ++producer)
+            fill[producer & (XDP_RING_SIZE - 1)] = (uint64_t) i * XDP_FRAME_SIZE;
+        __atomic_store_n(queue.fill.producer, producer, __ATOMIC_RELEASE);
+
+        struct sockaddr_xdp addr{};
+        addr.sxdp_family = AF_XDP;
+        addr.sxdp_ifindex = m_IfIndex;
+        addr.sxdp_queue_id = queueId;
+        // Generic mode only works with copies
+        addr.sxdp_flags = native ? 0 : XDP_COPY;
+        if (bind(queue.fd, (struct sockaddr *) &addr, sizeof(addr)) == -1) {
+            setError("bind(AF_XDP)");
+            return false;
+        }
+
+        union bpf_attr attr{};
+        attr.map_fd = (uint32_t) m_MapFd;
+        attr.key = reinterpret_cast<uint64_t>(&queueId);
+        attr.value = reinterpret_cast<uint64_t>(&queue.fd);
+        if (bpf(BPF_MAP_UPDATE_ELEM, &attr) < 0) {
+            setError("bpf(BPF_MAP_UPDATE_ELEM)");
+            return false;
+        }
+
+        struct epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u32 = queueId;
+        if (epoll_ctl(m_EpollFd, EPOLL_CTL_ADD, queue.fd, &event) == -1) {
+            setError("epoll_ctl");
+            return false;
+        }
+        return true;
+    }
+
+    bool XdpCapture::setLinkProgram(int programFd, uint32_t flags) {
+        int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+        if (fd < 0) {
+            setError("socket(AF_NETLINK)");
+            return false;
+        }
+
+        struct {
+            struct nlmsghdr header;
+            struct ifinfomsg info;
+            char attributes[64];
+        } request{};
+        request.header.nlmsg_len = NLMSG_LENGTH(sizeof(struct ifinfomsg));
+        request.header.nlmsg_type = RTM_SETLINK;
+        request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK;
+        request.header.nlmsg_seq = 1;
+        request.info.ifi_family = AF_UNSPEC;
+        request.info.ifi_index = (int) m_IfIndex;
+
+        auto addAttribute = [&request](struct rtattr *parent, uint16_t type, const void *data, size_t length) {
+            auto *attribute = reinterpret_cast<struct rtattr *>(reinterpret_cast<uint8_t *>(&request) +
+                                                               NLMSG_ALIGN(request.header.nlmsg_len));
+            attribute->rta_type = type;
+            attribute->rta_len = RTA_LENGTH(length);
+            if (length > 0)
+                memcpy(RTA_DATA(attribute), data, length);
+            request.header.nlmsg_len = NLMSG_ALIGN(request.header.nlmsg_len) + RTA_ALIGN(attribute->rta_len);
+            if (parent != nullptr)
+                parent->rta_len = (unsigned short) (reinterpret_cast<uint8_t *>(&request) +
+                                                    request.header.nlmsg_len - reinterpret_cast<uint8_t *>(parent));
+            return attribute;
+        };
+        auto *xdp = addAttribute(nullptr, NLA_F_NESTED | IFLA_XDP, nullptr, 0);
+        addAttribute(xdp, IFLA_XDP_FD, &programFd, sizeof(programFd));
+        addAttribute(xdp, IFLA_XDP_FLAGS, &flags, sizeof(flags));
+
+        bool success = false;
+        if (send(fd, &request, request.header.nlmsg_len, 0) < 0) {
+            setError("send(RTM_SETLINK)");
+        } else {
+            char reply[1024];
+            auto length = recv(fd, reply, sizeof(reply), 0);
+            auto *header = reinterpret_cast<struct nlmsghdr *>(reply);
+            if (length < 0) {
+                setError("recv(RTM_SETLINK)");
+            } else if (NLMSG_OK(header, (size_t) length) && header->nlmsg_type == NLMSG_ERROR) {
+                auto *error = static_cast<struct nlmsgerr *>(NLMSG_DATA(header));
+                errno = -error->error;
+                success = error->error == 0;
+                if (!success)
+                    setError("RTM_SETLINK(IFLA_XDP)");
+            }
+        }
+        ::close(fd);
+        return success;
+    }
+
+    void XdpCapture::close() {
+        if (m_Attached) {
+            setLinkProgram(-1, m_AttachFlags);
+            m_Attached = false;
+        }
+        for (auto &queue: m_Queues) {
+            if (queue.fill.map != nullptr)
+                munmap(queue.fill.map, queue.fill.mapSize);
+            if (queue.rx.map != nullptr)
+                munmap(queue.rx.map, queue.rx.mapSize);
+            if (queue.fd >= 0)
+                ::close(queue.fd);
+            if (queue.umem != nullptr)
+                munmap(queue.umem, (size_t) XDP_FRAME_COUNT * XDP_FRAME_SIZE);
+        }
+        m_Queues.clear();
+        m_BusyPoll = false;
+        if (m_EpollFd >= 0) {
+            ::close(m_EpollFd);
+            m_EpollFd = -1;
+        }
+        if (m_ProgramFd >= 0) {
+            ::close(m_ProgramFd);
+            m_ProgramFd = -1;
+        }
+        if (m_MapFd >= 0) {
+            ::close(m_MapFd);
+            m_MapFd = -1;
+        }
+    }
+
+    bool XdpCapture::enableBusyPoll(uint32_t usecs, uint32_t budget) {
+        for (auto &queue: m_Queues) {
+            int value = (int) usecs;
+            if (setsockopt(queue.fd, SOL_SOCKET, SO_BUSY_POLL, &value, sizeof(value)) == -1) {
+                setError("setsockopt(SO_BUSY_POLL)");
+                return false;
+            }
+            // Hands the device queue over to us, so the driver does not process it in softirq context as well
+            value = 1;
+            setsockopt(queue.fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &value, sizeof(value));
+            value = (int) std::max<uint32_t>(budget, 1);
+            setsockopt(queue.fd, SOL_SOCKET, SO_BUSY_POLL_BUDGET, &value, sizeof(value));
+        }
+        m_BusyPoll = true;
+        return true;
+    }
+
+    int XdpCapture::read(FrameCallback callback, void *ctx) {
+        int frames = 0;
+        for (auto &queue: m_Queues) {
+            // With busy polling the device queue is only processed when we ask for it through a receive call
+            if (m_BusyPoll)
+                recvfrom(queue.fd, nullptr, 0, MSG_DONTWAIT, nullptr, nullptr);
+            auto *rx = static_cast<struct xdp_desc *>(queue.rx.descriptors);
+            auto *fill = static_cast<uint64_t *>(queue.fill.descriptors);
+            uint32_t consumer = *queue.rx.consumer;
+            uint32_t producer = __atomic_load_n(queue.rx.producer, __ATOMIC_ACQUIRE);
+            uint32_t fillProducer = *queue.fill.producer;
+            for (; consumer != producer; ++consumer, ++fillProducer) {
+                const struct xdp_desc &desc = rx[consumer & (XDP_RING_SIZE - 1)];
+                callback(ctx, queue.umem + desc.addr, desc.len);
+                ++frames;
+                // Recycle the frame, the fill ring has room for every frame we own
+                fill[fillProducer & (XDP_RING_SIZE - 1)] = desc.addr & ~((uint64_t) XDP_FRAME_SIZE - 1);
+            }
+            __atomic_store_n(queue.fill.producer, fillProducer, __ATOMIC_RELEASE);
+            __atomic_store_n(queue.rx.consumer, consumer, __ATOMIC_RELEASE);
+        }
+        return frames;
+    }
+
+    uint64_t XdpCapture::drops() const {
+        uint64_t drops = 0;
+        for (const auto &queue: m_Queues) {
+            // Older kernels fill in fewer fields
+            struct xdp_statistics stats{};
+            socklen_t length = sizeof(stats);
+            if (getsockopt(queue.fd, SOL_XDP, XDP_STATISTICS, &stats, &length) == 0)
+                drops += stats.rx_dropped + stats.rx_invalid_descs + stats.rx_ring_full;
+        }
+        return drops;
+    }
+
+    void XdpCapture::setError(const char *what) {
+        m_Error = std::string(what) + ": " + strerror(errno);
+    }
+}